@@ -24,9 +24,37 @@
 #include "version.hh"
 
 #include <cstdlib>
+#include <fstream>
+#include <map>
+#include <set>
+
+#include <sys/stat.h>
 
 #include <boost/program_options.hpp>
 
+/// print hit/miss counters of the internal caches to stderr on destruction
+struct CacheStatsPrinter {
+    const char *name;
+    bool enabled;
+
+    CacheStatsPrinter(const char *name, bool enabled):
+        name(name),
+        enabled(enabled)
+    {
+    }
+
+    ~CacheStatsPrinter() {
+        if (!enabled)
+            return;
+
+        const MsgFilter::CacheStats fs = MsgFilter::inst().cacheStats();
+        std::cerr << name << ": filterMsg() cache: "
+            << fs.msgHits << " hits, " << fs.msgMisses << " misses\n"
+            << name << ": filterPath() cache: "
+            << fs.pathHits << " hits, " << fs.pathMisses << " misses\n";
+    }
+};
+
 int main(int argc, char *argv[])
 {
     using std::string;
@@ -35,24 +63,52 @@ int main(int argc, char *argv[])
     namespace po = boost::program_options;
     po::variables_map vm;
     po::options_description desc(string("Usage: ") + name
-            + " [options] old.err new.err, where options are");
+            + " [options] old.err [old2.err ...] new.err, where options are");
 
     using TStringList = std::vector<string>;
     string mode;
+    string fnIndex;
+    string fnOut;
+    string fnFixed;
+    string fnBaseline;
+    string outputDir;
+    int jobs;
 
     try {
         desc.add_options()
             ("fixed,x", "print fixed defects (just swaps the arguments)")
+            ("fixed-output", po::value<string>(&fnFixed),
+             "write fixed defects to the given file while the added defects "
+             "are printed, both scans are parsed only once")
+            ("added-and-fixed", "print a single JSON document with separate "
+             "sections for the added and fixed defects")
             ("ignore-path,z", "ignore directory structure when matching")
             ("show-internal,i", "include internal warnings in the output")
             ("quiet,q", "do not report any parsing errors")
+            ("cache-stats", "print hit/miss counters of the internal caches "
+             "to stderr on exit")
+            ("jobs", po::value<int>(&jobs)->default_value(1),
+             "number of threads to parse and match the scans")
             ("coverity-output,c", "write the result in Coverity format")
             ("json-output,j", "write the result in JSON format")
             ("html-output", "write the result in HTML format")
+            ("binary-output", "write the result in the binary format")
             ("file-rename,s", po::value<TStringList>(),
              "account the file base-name change, [OLD,NEW] (*testing*)")
             ("filter-file,f", po::value<TStringList>(),
-             "read custom filtering rules from a file in JSON format");
+             "read custom filtering rules from a file in JSON format")
+            ("build-index", po::value<string>(&fnIndex),
+             "write an index of the given baseline scan, which can be used "
+             "instead of old.err in subsequent runs with the same filtering "
+             "options")
+            ("output,o", po::value<string>(&fnOut),
+             "write the index to the given file instead of standard output")
+            ("baseline", po::value<string>(&fnBaseline),
+             "diff each of the given scans against this baseline, which is "
+             "read only once (requires --output-dir)")
+            ("output-dir", po::value<string>(&outputDir),
+             "with --baseline, write the result for each scan to a file of "
+             "the same name in the given directory");
 
         addColorOptions(&desc);
 
@@ -94,9 +150,11 @@ int main(int argc, char *argv[])
     const bool forceCov  = !!vm.count("coverity-output");
     const bool forceJson = !!vm.count("json-output");
     const bool useHtml = !!vm.count("html-output");
-    if (1 < static_cast<int>(forceCov) + forceJson + useHtml) {
+    const bool useBinary = !!vm.count("binary-output");
+    if (1 < static_cast<int>(forceCov) + forceJson + useHtml + useBinary) {
         std::cerr << name << ": error: options --coverity-output(-c) "
-            "--json-output(-j), and --html-output are mutually exclusive\n\n";
+            "--json-output(-j), --html-output, and --binary-output "
+            "are mutually exclusive\n\n";
         return 1;
     }
 
@@ -107,6 +165,8 @@ int main(int argc, char *argv[])
         format = FF_JSON;
     else if (useHtml)
         format = FF_HTML;
+    else if (useBinary)
+        format = FF_BINARY;
     else
         format = FF_AUTO;
 
@@ -117,6 +177,12 @@ int main(int argc, char *argv[])
         return 1;
     }
 
+    if (jobs < 1) {
+        std::cerr << name << ": error: invalid value for --jobs: "
+            << jobs << "\n";
+        return 1;
+    }
+
     // there are probably better solutions for this (Custom Validations)
     if (vm.count("file-rename")) {
         const TStringList &substList = vm["file-rename"].as<TStringList>();
@@ -132,32 +198,164 @@ int main(int argc, char *argv[])
         MsgFilter::inst().setFileNameSubstitution(sm[1], sm[2]);
     }
 
+    if (vm.count("ignore-path"))
+        MsgFilter::inst().setIgnorePath(true);
+
+    const bool showInternal = vm.count("show-internal");
+    const bool silent       = vm.count("quiet");
+
+    // print the statistics once the diff is done, whichever way it ends
+    const CacheStatsPrinter statsPrinter(name, vm.count("cache-stats"));
+
+    if (vm.count("filter-file")) {
+        const TStringList &filterFiles = vm["filter-file"].as<TStringList>();
+        if (!MsgFilter::inst().setFilterFiles(filterFiles, silent))
+            // an error message already printed out
+            return 1;
+    }
+
+    if (vm.count("build-index")) {
+        if (vm.count("input-file")) {
+            std::cerr << name << ": error: --build-index takes no other "
+                "input files\n";
+            return 1;
+        }
+
+        try {
+            InStream strBase(fnIndex, silent);
+            if (fnOut.empty())
+                return buildIndex(std::cout, strBase);
+
+            std::ofstream strOut(fnOut, std::ios::binary);
+            if (!strOut) {
+                std::cerr << fnOut << ": failed to open output file\n";
+                return EXIT_FAILURE;
+            }
+
+            return buildIndex(strOut, strBase);
+        }
+        catch (const InFileException &e) {
+            std::cerr << e.fileName << ": failed to open input file\n";
+            return EXIT_FAILURE;
+        }
+    }
+
     if (!vm.count("input-file")) {
         desc.print(std::cerr);
         return 1;
     }
 
     const TStringList &files = vm["input-file"].as<TStringList>();
-    if (2 != files.size()) {
+    if (!fnBaseline.empty()) {
+        if (outputDir.empty()) {
+            std::cerr << name << ": error: --baseline requires --output-dir\n";
+            return 1;
+        }
+
+        if (vm.count("fixed") || vm.count("added-and-fixed")
+                || !fnFixed.empty())
+        {
+            std::cerr << name << ": error: --baseline can be used only to "
+                "print added defects\n";
+            return 1;
+        }
+
+        // name the output files by the base names of the input files
+        TStringList outFiles;
+        std::set<string> baseNames;
+        for (const string &fn : files) {
+            const string baseName = fn.substr(fn.rfind('/') + 1U);
+            if (!baseNames.insert(baseName).second) {
+                std::cerr << name << ": error: multiple input files named "
+                    << baseName << "\n";
+                return 1;
+            }
+
+            outFiles.push_back(outputDir + "/" + baseName);
+        }
+
+        // the input files are mapped while the output files are written,
+        // so none of the output files may refer to any of the input files
+        typedef std::pair<dev_t, ino_t> TFileId;
+        std::map<TFileId, string> inFiles;
+        struct stat st;
+        if (!stat(fnBaseline.c_str(), &st))
+            inFiles[TFileId(st.st_dev, st.st_ino)] = fnBaseline;
+        for (const string &fn : files)
+            if (!stat(fn.c_str(), &st))
+                inFiles[TFileId(st.st_dev, st.st_ino)] = fn;
+
+        for (const string &fn : outFiles) {
+            if (stat(fn.c_str(), &st))
+                continue;
+
+            const auto it = inFiles.find(TFileId(st.st_dev, st.st_ino));
+            if (it != inFiles.end()) {
+                std::cerr << name << ": error: output file " << fn
+                    << " would overwrite input file " << it->second << "\n";
+                return 1;
+            }
+        }
+
+        try {
+            InStream strOld(fnBaseline, silent);
+            return diffScansBatch(strOld, files, outFiles, showInternal,
+                    format, cm, jobs);
+        }
+        catch (const InFileException &e) {
+            std::cerr << e.fileName << ": failed to open input file\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (files.size() < 2U) {
         desc.print(std::cerr);
         return 1;
     }
 
-    if (vm.count("ignore-path"))
-        MsgFilter::inst().setIgnorePath(true);
+    if (2U < files.size()) {
+        // diff the last scan against the union of all the preceding scans
+        if (vm.count("fixed") || vm.count("added-and-fixed")
+                || !fnFixed.empty())
+        {
+            std::cerr << name << ": error: multiple old scans can be used "
+                "only to print added defects\n";
+            return 1;
+        }
+
+        const TStringList oldFiles(files.begin(), files.end() - 1);
+        try {
+            InStream strNew(files.back(), silent);
+            return diffScansUnion(std::cout, oldFiles, strNew, showInternal,
+                    format, cm, jobs);
+        }
+        catch (const InFileException &e) {
+            std::cerr << e.fileName << ": failed to open input file\n";
+            return EXIT_FAILURE;
+        }
+    }
 
     const bool swap = vm.count("fixed");
     const string &fnOld = files[swap];
     const string &fnNew = files[!swap];
 
-    const bool showInternal = vm.count("show-internal");
-    const bool silent       = vm.count("quiet");
+    const bool both = vm.count("added-and-fixed");
+    if (both && (forceCov || useHtml || useBinary)) {
+        std::cerr << name << ": error: --added-and-fixed writes only "
+            "the JSON format\n";
+        return 1;
+    }
 
-    if (vm.count("filter-file")) {
-        const TStringList &filterFiles = vm["filter-file"].as<TStringList>();
-        if (!MsgFilter::inst().setFilterFiles(filterFiles, silent))
-            // an error message already printed out
-            return 1;
+    if ((both || !fnFixed.empty()) && swap) {
+        std::cerr << name << ": error: --fixed(-x) cannot be combined "
+            "with --fixed-output or --added-and-fixed\n";
+        return 1;
+    }
+
+    if (both && !fnFixed.empty()) {
+        std::cerr << name << ": error: options --fixed-output and "
+            "--added-and-fixed are mutually exclusive\n";
+        return 1;
     }
 
     try {
@@ -165,8 +363,24 @@ int main(int argc, char *argv[])
         InStream strOld(fnOld, silent);
         InStream strNew(fnNew, silent);
 
+        if (both)
+            return diffScansBoth(std::cout, nullptr, strOld, strNew,
+                    showInternal, format, cm);
+
+        if (!fnFixed.empty()) {
+            std::ofstream strFixed(fnFixed);
+            if (!strFixed) {
+                std::cerr << fnFixed << ": failed to open output file\n";
+                return EXIT_FAILURE;
+            }
+
+            return diffScansBoth(std::cout, &strFixed, strOld, strNew,
+                    showInternal, format, cm);
+        }
+
         // run the core
-        return diffScans(std::cout, strOld, strNew, showInternal, format, cm);
+        return diffScans(std::cout, strOld, strNew, showInternal, format, cm,
+                jobs);
     }
     catch (const InFileException &e) {
         std::cerr << e.fileName << ": failed to open input file\n";
@@ -20,16 +20,20 @@
 #include "abstract-filter.hh"
 #include "filter.hh"
 #include "msg-filter.hh"
+#include "parallel.hh"
 #include "parser.hh"
 #include "parser-common.hh"
 #include "regex.hh"
+#include "src-cache.hh"
 #include "version.hh"
+#include "writer-binary.hh"
 #include "writer-cov.hh"
 #include "writer-json.hh"
 
 #include <cstdlib>
 #include <iomanip>
 #include <map>
+#include <unordered_map>
 
 #include <boost/program_options.hpp>
 
@@ -195,39 +199,71 @@ class MsgPredicate: public IPredicate {
         }
 };
 
+/// regex search memoized for inputs from a small closed set (checkers, tools)
+/// or for interned strings, which are looked up by their identity
+class CachedRegexSearch {
+    private:
+        const RE re_;
+        mutable std::unordered_map<std::string, bool> cache_;
+        mutable std::unordered_map<Symbol, bool> symCache_;
+
+    public:
+        CachedRegexSearch(const RE &re):
+            re_(re)
+        {
+        }
+
+        bool operator()(const std::string &str) const {
+            const auto it = cache_.find(str);
+            if (cache_.end() != it)
+                return it->second;
+
+            return cache_[str] = boost::regex_search(str, re_);
+        }
+
+        bool operator()(const Symbol &sym) const {
+            const auto it = symCache_.find(sym);
+            if (symCache_.end() != it)
+                return it->second;
+
+            return symCache_[sym] = boost::regex_search(sym.str(), re_);
+        }
+};
+
 class ToolPredicate: public IPredicate {
     private:
         const ImpliedAttrDigger digger_;
-        const RE re_;
+        const CachedRegexSearch search_;
 
     public:
         ToolPredicate(const RE &re):
-            re_(re)
+            search_(re)
         {
         }
 
-        bool matchDef(const Defect &defOrig) const override {
+        bool matchDef(const Defect &def) const override {
             // detect tool in case it is not explicitly specified
-            Defect def = defOrig;
-            digger_.inferToolFromChecker(&def, /* onlyIfMissing */ true);
+            const std::string &tool = (def.tool.empty())
+                ? digger_.toolByChecker(def.checker)
+                : def.tool;
 
-            return boost::regex_search(def.tool, re_);
+            return search_(tool);
         }
 };
 
 class KeyEventPredicate: public IPredicate {
     private:
-        const RE re_;
+        const CachedRegexSearch search_;
 
     public:
         KeyEventPredicate(const RE &re):
-            re_(re)
+            search_(re)
         {
         }
 
         bool matchDef(const Defect &def) const override {
             const DefEvent &keyEvent = def.events[def.keyEventIdx];
-            return boost::regex_search(keyEvent.event, re_);
+            return search_(keyEvent.event);
         }
 };
 
@@ -249,32 +285,32 @@ class ErrorPredicate: public IPredicate {
 
 class PathPredicate: public IPredicate {
     private:
-        const RE re_;
+        const CachedRegexSearch search_;
 
     public:
         PathPredicate(const RE &re):
-            re_(re)
+            search_(re)
         {
         }
 
         bool matchDef(const Defect &def) const override {
             const DefEvent &evt = def.events[def.keyEventIdx];
-            return boost::regex_search(evt.fileName, re_);
+            return search_(evt.fileName);
         }
 };
 
 class CheckerPredicate: public IPredicate {
     private:
-        const RE re_;
+        const CachedRegexSearch search_;
 
     public:
         CheckerPredicate(const RE &re):
-            re_(re)
+            search_(re)
         {
         }
 
         bool matchDef(const Defect &def) const override {
-            return boost::regex_search(def.checker, re_);
+            return search_(def.checker);
         }
 };
 
@@ -303,35 +339,26 @@ class SrcAnnotPredicate: public IPredicate {
         {
         }
 
-        // FIXME: this implementation is desperately inefficient
         bool matchDef(const Defect &def) const override {
             const DefEvent &evt = def.events[def.keyEventIdx];
             const std::string &fname = evt.fileName;
-            std::fstream fstr(fname.c_str(), std::ios::in);
-            if (!fstr) {
+            SrcFileCache &cache = SrcFileCache::inst();
+            if (cache.lineCount(fname) < 0) {
                 std::cerr << "failed to open source file: " << fname << "\n";
                 return false;
             }
 
-            bool matched = false;
-
             const int lineno = evt.line;
-            std::string line;
-            for (int i = 1; i <= lineno; i++) {
-                if (std::getline(fstr, line))
-                    continue;
-
+            boost::string_view line("");
+            if (0 < lineno && !cache.getLine(&line, fname, lineno)) {
                 std::cerr << "failed to seek line "
                     << lineno << " in the source file: "
                     << fname << "\n";
 
-                goto fail;
+                return false;
             }
 
-            matched = boost::regex_search(line, re_);
-fail:
-            fstr.close();
-            return matched;
+            return boost::regex_search(line.begin(), line.end(), re_);
         }
 };
 
@@ -356,6 +383,10 @@ class WriterFactory {
             return new JsonWriter(std::cout, FF_JSON);
         }
 
+        static AbstractWriter* createBinary() {
+            return new BinaryWriter(std::cout);
+        }
+
         static AbstractWriter* createSarif() {
             return new JsonWriter(std::cout, FF_SARIF);
         }
@@ -370,6 +401,7 @@ class WriterFactory {
         }
 
         WriterFactory() {
+            tbl_["binary"]          = createBinary;
             tbl_["dig_key_events"]  = createKeyEventPrinter;
             tbl_["evtstat"]         = createEvtStat;
             tbl_["files"]           = createFiles;
@@ -503,11 +535,12 @@ bool chainDecoratorGeneric(
     }
 }
 
-template <class TDecorator>
+template <class TDecorator, class... TArgs>
 bool chainDecoratorIntArg(
         AbstractWriter            **pEng,
         const po::variables_map    &vm,
-        const char                 *key)
+        const char                 *key,
+        TArgs...                    args)
 {
     const auto it = vm.find(key);
     if (it == vm.end())
@@ -524,10 +557,25 @@ bool chainDecoratorIntArg(
     }
 
     // chain the decorator
-    *pEng = new TDecorator(*pEng, val);
+    *pEng = new TDecorator(*pEng, val, args...);
     return true;
 }
 
+/// print hit/miss counters of the internal caches to stderr
+static void printCacheStats()
+{
+    const MsgFilter::CacheStats fs = MsgFilter::inst().cacheStats();
+    std::cerr << name << ": filterMsg() cache: "
+        << fs.msgHits << " hits, " << fs.msgMisses << " misses\n"
+        << name << ": filterPath() cache: "
+        << fs.pathHits << " hits, " << fs.pathMisses << " misses\n";
+
+    const SrcFileCache::CacheStats ss = SrcFileCache::inst().cacheStats();
+    std::cerr << name << ": source file cache: "
+        << ss.hits << " hits, " << ss.misses << " misses, "
+        << ss.evictions << " evictions\n";
+}
+
 int main(int argc, char *argv[])
 {
     using std::string;
@@ -540,6 +588,7 @@ int main(int argc, char *argv[])
 
     typedef std::vector<string> TStringList;
     string mode;
+    int jobs;
 
     try {
         desc.add_options()
@@ -557,6 +606,7 @@ int main(int argc, char *argv[])
             ("prune-events",        po::value<int>(),           "event is preserved if its verbosity level is below the given number")
             ("warning-rate-limit",  po::value<int>(),           "stop processing a warning if the count of its occurrences exceeds the specified limit")
             ("remove-duplicates,u",                             "remove defects that are not unique by their key event")
+            ("verify-fingerprints",                             "keep exact keys for --remove-duplicates and --warning-rate-limit and report collisions of their fingerprints")
             ("set-scan-prop",       po::value<TStringList>(),   "NAME:VALUE pair to override the specified scan property")
             ("strip-path-prefix",   po::value<string>(),        "string prefix to strip from path (applied after all filters)")
             ("prepend-path-prefix", po::value<string>(),        "string prefix to prepend to relative paths (applied after all filters)")
@@ -569,9 +619,12 @@ int main(int argc, char *argv[])
         addColorOptions(&desc);
         desc.add_options()
             ("quiet,q",                                         "do not report any parsing errors")
+            ("cache-stats",                                     "print hit/miss counters of the internal caches to stderr on exit")
+            ("jobs",                po::value<int>(&jobs)
+                                    ->default_value(1),         "number of input files to parse in parallel")
 
             ("mode",                po::value<string>(&mode)
-                                    ->default_value("grep"),    "grep, json, evtstat, files, filestat, grouped, sarif, stat, or dig_key_events")
+                                    ->default_value("grep"),    "grep, json, binary, evtstat, files, filestat, grouped, sarif, stat, or dig_key_events")
 
             ("help",                                            "print the usage of csgrep")
             ("version",                                         "print the version of csgrep");
@@ -619,6 +672,12 @@ int main(int argc, char *argv[])
 
     const bool silent = vm.count("quiet");
 
+    if (jobs < 1) {
+        std::cerr << name << ": error: invalid value for --jobs: "
+            << jobs << "\n";
+        return 1;
+    }
+
     if (vm.count("filter-file")) {
         const TStringList &filterFiles = vm["filter-file"].as<TStringList>();
         if (!MsgFilter::inst().setFilterFiles(filterFiles, silent))
@@ -656,11 +715,13 @@ int main(int argc, char *argv[])
     if (vm.count("drop-scan-props"))
         eng = new DropScanProps(eng);
 
+    const bool verifyFp = vm.count("verify-fingerprints");
     if (vm.count("remove-duplicates"))
-        eng = new DuplicateFilter(eng);
+        eng = new DuplicateFilter(eng, verifyFp);
 
     if (!chainDecoratorIntArg<EventPrunner>(&eng, vm, "prune-events")
-            || !chainDecoratorIntArg<RateLimitter>(&eng, vm, "warning-rate-limit")
+            || !chainDecoratorIntArg<RateLimitter>(&eng, vm,
+                "warning-rate-limit", verifyFp)
             || !chainDecoratorIntArg<CtxEmbedder>(&eng, vm, "embed-context"))
         // error message already printed, eng already feeed
         return 1;
@@ -675,13 +736,20 @@ int main(int argc, char *argv[])
     }
     else {
         const TStringList &files = vm["input-file"].as<TStringList>();
-        for (const string &fileName : files) {
-            if (!eng->handleFile(fileName, silent))
+        const auto handler = [eng, &hasError](Parser &parser, size_t) {
+            if (!eng->handleFile(parser))
                 hasError = true;
-        }
+        };
+
+        if (!parseFiles(files, silent, jobs, handler))
+            hasError = true;
     }
 
     eng->flush();
     delete eng;
+
+    if (vm.count("cache-stats"))
+        printCacheStats();
+
     return hasError;
 }
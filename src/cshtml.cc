@@ -78,7 +78,8 @@ int main(int argc, char *argv[])
             ("defect-url-template", po::value(&defUrlTemplate),
              "e.g. http://localhost/index.php?proj=%d&defect=%d")
             ("diff-base", po::value(&fnBase),
-             "use the given list of defects as diff base")
+             "use the given list of defects (or an index written by csdiff "
+             "--build-index) as diff base")
             ("diff-base-ignore-checkers", po::value(&checkerIgnRegex),
              "do not diff base for checkers matching the given regex")
             ("plain-text-url", po::value(&plainTextUrl),
@@ -146,12 +147,19 @@ int main(int argc, char *argv[])
         // read old defects if given
         if (!fnBase.empty()) {
             InStream strBase(fnBase, silent);
-            Parser pBase(strBase);
-            Defect def;
-            while (pBase.getNext(&def))
-                baseLookup.hashDefect(def);
-
-            baseProps = pBase.getScanProps();
+            if (DefLookup::isIndex(strBase)) {
+                // index written by csdiff --build-index
+                if (!baseLookup.readIndex(strBase, &baseProps))
+                    return EXIT_FAILURE;
+            }
+            else {
+                Parser pBase(strBase);
+                Defect def;
+                while (pBase.getNext(&def))
+                    baseLookup.hashDefect(def);
+
+                baseProps = pBase.getScanProps();
+            }
         }
 
         // initialize HTML writer
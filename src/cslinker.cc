@@ -21,8 +21,10 @@
 #include "cwe-mapper.hh"
 #include "deflookup.hh"
 #include "instream.hh"
+#include "parallel.hh"
 #include "parser-gcc.hh"
 #include "version.hh"
+#include "writer-binary.hh"
 #include "writer-json.hh"
 
 #include <boost/program_options.hpp>
@@ -87,16 +89,17 @@ bool loadPropsFromIniFile(
     }
 }
 
-class ImpFlagDecorator: public GenericAbstractFilter {
+class ImpFlagDecorator: public AbstractTransformer {
     public:
         ImpFlagDecorator(AbstractWriter *writer):
-            GenericAbstractFilter(writer)
+            AbstractTransformer(writer)
         {
         }
 
         void hashImpDefect(const Defect &);
 
-        void handleDef(const Defect &def) override;
+    protected:
+        void transformDef(Defect *pDef) override;
 
     private:
         DefLookup impSet_;
@@ -107,39 +110,29 @@ void ImpFlagDecorator::hashImpDefect(const Defect &impDef)
     impSet_.hashDefect(impDef);
 }
 
-void ImpFlagDecorator::handleDef(const Defect &defOrig)
+void ImpFlagDecorator::transformDef(Defect *pDef)
 {
-    if (impSet_.lookup(defOrig)) {
+    if (impSet_.lookup(*pDef))
         // found -> set "imp" flag to 1
-        Defect def = defOrig;
-        def.imp = 1;
-        agent_->handleDef(def);
-    }
-    else {
-        agent_->handleDef(defOrig);
-    }
+        pDef->imp = 1;
 }
 
-class ParsingRulesDecorator: public GenericAbstractFilter {
+class ParsingRulesDecorator: public AbstractTransformer {
     public:
         ParsingRulesDecorator(AbstractWriter *writer):
-            GenericAbstractFilter(writer)
+            AbstractTransformer(writer)
         {
         }
 
-        void handleDef(const Defect &def) override;
+    protected:
+        void transformDef(Defect *pDef) override {
+            gccPostProc_.apply(pDef);
+        }
 
     private:
         GccPostProcessor gccPostProc_;
 };
 
-void ParsingRulesDecorator::handleDef(const Defect &defOrig)
-{
-    Defect def = defOrig;
-    gccPostProc_.apply(&def);
-    agent_->handleDef(def);
-}
-
 template <class TVal, class TVar>
 inline TVal valueOf(const TVar &var)
 {
@@ -163,12 +156,15 @@ int main(int argc, char *argv[])
 
     try {
         desc.add_options()
+            ("binary-output", "write the result in the binary format")
             ("cwelist", po::value<string>(),
              "(re)assign CWE numbers to defects by the given CSV list")
             ("implist", po::value<string>(),
              "mark reports from the specified list as important")
             ("inifile", po::value<string>(),
              "load scan properties from the given INI file")
+            ("jobs", po::value<int>()->default_value(1),
+             "number of input files to parse in parallel")
             ("reapply-parsing-rules", "canonicalize data originally parsed "
              "by an older version of the parser")
             ("quiet,q", "do not report non-fatal errors")
@@ -210,6 +206,12 @@ int main(int argc, char *argv[])
     const string fnImp = valueOf<string>(vm["implist"]);
     const string fnIni = valueOf<string>(vm["inifile"]);
     const bool silent = vm.count("quiet");
+    const int jobs = vm["jobs"].as<int>();
+    if (jobs < 1) {
+        std::cerr << name << ": error: invalid value for --jobs: "
+            << jobs << "\n";
+        return 1;
+    }
 
     const po::variables_map::const_iterator it = vm.find("input-file");
     TStringList files;
@@ -221,8 +223,13 @@ int main(int argc, char *argv[])
         return 1;
     }
 
-    AbstractWriter *jsonWriter = new JsonWriter(std::cout);
-    ImpFlagDecorator *impDec = new ImpFlagDecorator(jsonWriter);
+    AbstractWriter *outWriter;
+    if (vm.count("binary-output"))
+        outWriter = new BinaryWriter(std::cout);
+    else
+        outWriter = new JsonWriter(std::cout);
+
+    ImpFlagDecorator *impDec = new ImpFlagDecorator(outWriter);
     CweMapDecorator *cweDec = new CweMapDecorator(impDec, silent);
     AbstractWriter *writer = cweDec;
     if (vm.count("reapply-parsing-rules"))
@@ -262,33 +269,24 @@ int main(int argc, char *argv[])
     if (!filesCnt && !fnIni.empty() && !loadPropsFromIniFile(*writer, fnIni))
         hasError = true;
 
-    for (unsigned i = 0U; i < filesCnt; ++i) {
-        const string &fnErr = files[i];
+    const auto handler = [&](Parser &pErr, const size_t i) {
+        if (!i) {
+            // try to load scan properties from the first input file
+            writer->setScanProps(pErr.getScanProps());
 
-        try {
-            // initialize parser for .err
-            InStream strErr(fnErr, silent);
-            Parser pErr(strErr);
-
-            if (!i) {
-                // try to load scan properties from the first input file
-                writer->setScanProps(pErr.getScanProps());
+            // load .ini if available
+            if (!fnIni.empty() && !loadPropsFromIniFile(*writer, fnIni))
+                hasError = true;
+        }
 
-                // load .ini if available
-                if (!fnIni.empty() && !loadPropsFromIniFile(*writer, fnIni))
-                    hasError = true;
-            }
+        // process a single input file
+        writer->handleFile(pErr);
 
-            // process a single input file
-            writer->handleFile(pErr);
+        hasError |= pErr.hasError();
+    };
 
-            hasError |= pErr.hasError();
-        }
-        catch (const InFileException &e) {
-            printError(e);
-            hasError = true;
-        }
-    }
+    if (!parseFiles(files, silent, jobs, handler))
+        hasError = true;
 
     writer->flush();
     delete writer;
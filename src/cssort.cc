@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2012-2022 Red Hat, Inc.
+ * Copyright (C) 2012-2023 Red Hat, Inc.
  *
  * This file is part of csdiff.
  *
@@ -17,43 +17,336 @@
  * along with csdiff.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include "regex.hh"
+#include "parallel.hh"
+#include "parser-binary.hh"
 #include "version.hh"
+#include "writer-binary.hh"
 #include "writer.hh"
 
+#include <cerrno>
+#include <cstdlib>
+#include <fstream>
+#include <thread>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <boost/program_options.hpp>
 
+static std::string name;
+
+typedef std::vector<std::string> TStringList;
+
+class AbstractSort: public AbstractWriter {
+    public:
+        /// if all the given files are sorted under the key, merge them to the
+        /// output and return true, otherwise return false and write nothing
+        virtual bool mergeFiles(
+                const TStringList          &files,
+                bool                        silent,
+                unsigned                    jobs,
+                bool                       *pHasError) = 0;
+
+        /// return true if the defects could not be sorted because of an error
+        /// on a temporary file, the output is incomplete then
+        virtual bool hasError() const = 0;
+};
+
 class SortFactory {
     public:
-        AbstractWriter* create(const std::string &key, EColorMode cm);
+        AbstractSort* create(
+                const std::string          &key,
+                EFileFormat                 format,
+                EColorMode                  cm,
+                size_t                      maxMemory,
+                unsigned                    jobs);
+};
+
+/// estimated count of bytes of memory occupied by the given defect
+static size_t memSize(const Defect &def)
+{
+    size_t size = sizeof(Defect)
+        + def.annotation.capacity()
+        + def.function.capacity()
+        + def.language.capacity()
+        + def.tool.capacity()
+        + def.events.capacity() * sizeof(DefEvent);
+
+    for (const DefEvent &evt : def.events)
+        size += evt.msg.capacity();
+
+    return size;
+}
+
+/// sorted sequence of defects spilled to a temporary file in the binary format
+///
+/// The binary format keeps only strings with few distinct values (checkers,
+/// file names, events) in its string table, so the memory of the writer of
+/// a merged run does not grow with the count of defects merged into it.
+class SortRun {
+    public:
+        /// runs created by merging of N runs have level of those runs plus one
+        explicit SortRun(const unsigned level):
+            level_(level)
+        {
+        }
+
+        SortRun(const SortRun &) = delete;
+        SortRun& operator=(const SortRun &) = delete;
+
+        ~SortRun() {
+            if (!fileName_.empty())
+                unlink(fileName_.c_str());
+        }
+
+        unsigned level() const {
+            return level_;
+        }
+
+        /// create a new temporary file, return false on error
+        bool create();
+
+        /// writer of the defects into the temporary file
+        AbstractWriter* writer() const {
+            return writer_.get();
+        }
+
+        /// finish writing of the temporary file, return false on error
+        bool finish();
+
+        /// open the written file for reading, return false on error
+        bool open();
+
+        bool readNext(Defect *pDef) {
+            return parser_->getNext(pDef);
+        }
+
+        /// return true if the opened file could not be read completely
+        bool hasError() const {
+            return parser_->hasError();
+        }
+
+    private:
+        const unsigned                  level_;
+        std::string                     fileName_;
+        std::ofstream                   outStr_;
+        std::unique_ptr<BinaryWriter>   writer_;
+        std::unique_ptr<InStream>       input_;
+        std::unique_ptr<BinaryParser>   parser_;
+};
+
+bool SortRun::create()
+{
+    const char *tmpDir = getenv("TMPDIR");
+    std::string tpl = (tmpDir && *tmpDir) ? tmpDir : "/tmp";
+    tpl += "/cssort-XXXXXX";
+
+    const int fd = mkstemp(&tpl[0]);
+    if (fd < 0)
+        return false;
+
+    close(fd);
+    fileName_ = tpl;
+
+    outStr_.open(fileName_, std::ios::binary);
+    writer_.reset(new BinaryWriter(outStr_));
+    return !outStr_.fail();
+}
+
+bool SortRun::finish()
+{
+    writer_->flush();
+    writer_.reset();
+    outStr_.close();
+    return !outStr_.fail();
+}
+
+bool SortRun::open()
+{
+    try {
+        input_.reset(new InStream(fileName_));
+    }
+    catch (const InFileException &e) {
+        std::cerr << e.fileName << ": failed to open temporary file\n";
+        return false;
+    }
+
+    // the opened file stays accessible after it is unlinked
+    unlink(fileName_.c_str());
+    fileName_.clear();
+
+    parser_.reset(new BinaryParser(*input_));
+    return true;
+}
+
+/// vectors shorter than this are not worth sorting by multiple threads, the
+/// count can be lowered by the CSDIFF_PARALLEL_SORT_MIN environment variable
+/// to exercise the parallel sort on small inputs in tests
+static size_t parallelSortMin()
+{
+    static const size_t cnt = []() -> size_t {
+        const char *env = getenv("CSDIFF_PARALLEL_SORT_MIN");
+        const unsigned long val = (env) ? strtoul(env, nullptr, 0) : 0UL;
+        return (val)
+            ? val
+            : 0x4000;
+    }();
+
+    return cnt;
+}
+
+/// sort chunks of the vector by separate threads and merge them pairwise
+template <class T>
+void parallelSort(std::vector<T> *pVec, const unsigned jobs)
+{
+    const size_t cnt = pVec->size();
+    if (jobs < 2U || cnt < parallelSortMin())
+        // not worth starting any threads
+        return std::sort(pVec->begin(), pVec->end());
+
+    // boundaries of the chunks
+    std::vector<size_t> bounds;
+    for (size_t i = 0U; i <= jobs; ++i)
+        bounds.push_back(cnt * i / jobs);
+
+    const auto beg = pVec->begin();
+    std::vector<std::thread> threads;
+    for (size_t i = 0U; i + 1U < bounds.size(); ++i)
+        threads.emplace_back([beg, &bounds, i]() {
+            std::sort(beg + bounds[i], beg + bounds[i + 1U]);
+        });
+
+    for (std::thread &t : threads)
+        t.join();
+
+    // merge neighbouring chunks until only one chunk remains
+    while (2U < bounds.size()) {
+        threads.clear();
+        std::vector<size_t> next;
+        size_t i = 0U;
+        for (; i + 2U < bounds.size(); i += 2U) {
+            const size_t b0 = bounds[i];
+            const size_t b1 = bounds[i + 1U];
+            const size_t b2 = bounds[i + 2U];
+            threads.emplace_back([beg, b0, b1, b2]() {
+                std::inplace_merge(beg + b0, beg + b1, beg + b2);
+            });
+            next.push_back(b0);
+        }
+
+        // odd chunk left for the next round
+        for (; i + 1U < bounds.size(); ++i)
+            next.push_back(bounds[i]);
+
+        next.push_back(bounds.back());
+        for (std::thread &t : threads)
+            t.join();
+
+        bounds.swap(next);
+    }
+}
+
+/// sort key of a defect extracted once before sorting
+template <class TItem>
+struct SortKey {
+    const TItem            *def;
+    size_t                  idx;        ///< index in the input, breaks ties
+    boost::string_view      scCode;     ///< used only by DefByChecker
 };
 
 template <class TItem>
-class GenericSort: public AbstractWriter {
+class GenericSort: public AbstractSort {
     private:
         typedef std::vector<TItem> TCont;
+        typedef std::unique_ptr<SortRun> TRunPtr;
+        typedef std::vector<SortKey<TItem>> TKeyList;
+
+        TCont                   cont_;
+        TScanProps              scanProps_;
+
+        /// FF_AUTO means the same format as the input format
+        const EFileFormat       format_;
+        EColorMode              cm_;
+        const unsigned          jobs_;
+
+        /// zero means that all defects are sorted in memory
+        size_t                  maxMemory_;
+        size_t                  memUsed_ = 0U;
+
+        /// set on a failure of a temporary file, defects are dropped then
+        bool                    failed_ = false;
 
-        TCont           cont_;
-        TScanProps      scanProps_;
-        EColorMode      cm_;
+        /// sorted runs in the order of creation
+        std::vector<TRunPtr>    runs_;
+
+        /// count of runs of the same level that are merged into a single run
+        static constexpr size_t fanIn = 0x10;
+
+        void addDef() {
+            if (!maxMemory_)
+                return;
+
+            memUsed_ += memSize(cont_.back());
+            if (maxMemory_ < memUsed_ && !this->spill())
+                this->fail();
+        }
+
+        /// drop all the defects, nothing is written by flush() then
+        void fail() {
+            failed_ = true;
+            maxMemory_ = 0U;
+            cont_.clear();
+            runs_.clear();
+        }
+
+        void sortKeys(TKeyList *pKeys) const;
+        bool spill();
+        bool mergeRuns(AbstractWriter *writer, size_t first, bool withMemory);
+        int checkFile(TScanProps *pProps, const std::string &fileName);
 
     public:
-        GenericSort(const EColorMode cm):
-            cm_(cm)
+        GenericSort(
+                const EFileFormat           format,
+                const EColorMode            cm,
+                const size_t                maxMemory,
+                const unsigned              jobs):
+            format_(format),
+            cm_(cm),
+            jobs_(jobs),
+            maxMemory_(maxMemory)
         {
         }
 
         void flush() override {
-            // sort the container
-            std::sort(cont_.begin(), cont_.end());
+            if (failed_)
+                return;
+
+            // use the same output format is the input format unless specified
+            const EFileFormat format = (FF_AUTO == format_)
+                ? this->inputFormat()
+                : format_;
 
-            // use the same output format is the input format
             TWriterPtr writer =
-                createWriter(std::cout, this->inputFormat(), cm_, scanProps_);
+                createWriter(std::cout, format, cm_, scanProps_);
 
-            // write the data
-            for (const Defect &def : cont_)
-                writer->handleDef(def);
+            if (!runs_.empty()) {
+                // merge the sorted runs directly into the writer
+                if (!this->mergeRuns(writer.get(), 0U, /* withMemory */ true)) {
+                    this->fail();
+                    return;
+                }
+            }
+            else {
+                // sort the keys of the defects
+                TKeyList keys;
+                this->sortKeys(&keys);
+
+                // write the data, the container is not needed any more
+                for (const SortKey<TItem> &key : keys)
+                    writer->handleDef(std::move(cont_[key.idx]));
+
+                cont_.clear();
+            }
 
             // flush data
             writer->flush();
@@ -63,90 +356,535 @@ class GenericSort: public AbstractWriter {
             return scanProps_;
         }
 
+        bool hasError() const override {
+            return failed_;
+        }
+
         void setScanProps(const TScanProps &scanProps) override {
             scanProps_ = scanProps;
         }
 
+        bool mergeFiles(
+                const TStringList          &files,
+                bool                        silent,
+                unsigned                    jobs,
+                bool                       *pHasError) override;
+
     protected:
         void handleDef(const Defect &def) override {
+            if (failed_)
+                return;
+
             cont_.push_back(static_cast<const TItem &>(def));
+            this->addDef();
+        }
+
+        void handleDef(Defect &&def) override {
+            if (failed_)
+                return;
+
+            cont_.push_back(static_cast<TItem &&>(def));
+            this->addDef();
         }
 };
 
-inline bool cmpFileNames(const Defect &a, const Defect &b)
+/// extract sort keys of the defects held in memory and sort them
+template <class TItem>
+void GenericSort<TItem>::sortKeys(TKeyList *pKeys) const
+{
+    const size_t cnt = cont_.size();
+    pKeys->resize(cnt);
+    for (size_t i = 0U; i < cnt; ++i)
+        initKey(&(*pKeys)[i], cont_[i], i);
+
+    parallelSort(pKeys, jobs_);
+}
+
+/// sort the defects held in memory and write them to a new run, then merge
+/// the trailing runs of the same level to keep the count of runs logarithmic,
+/// return false if the defects cannot be sorted any more
+template <class TItem>
+bool GenericSort<TItem>::spill()
+{
+    // the keys break ties by index so that the merge preserves the order
+    // of equal defects
+    TKeyList keys;
+    this->sortKeys(&keys);
+
+    TRunPtr run(new SortRun(/* level */ 0U));
+    bool ok = run->create();
+    if (ok) {
+        for (const SortKey<TItem> &key : keys)
+            run->writer()->handleDef(*key.def);
+
+        ok = run->finish();
+    }
+
+    if (!ok) {
+        std::cerr << name << ": warning: failed to write a temporary file, "
+            "sorting the remaining defects in memory\n";
+        maxMemory_ = 0U;
+        return true;
+    }
+
+    runs_.push_back(std::move(run));
+    cont_.clear();
+    memUsed_ = 0U;
+
+    for (;;) {
+        const size_t cnt = runs_.size();
+        if (cnt < fanIn)
+            return true;
+
+        const size_t first = cnt - fanIn;
+        const unsigned level = runs_.back()->level();
+        if (runs_[first]->level() != level)
+            return true;
+
+        run.reset(new SortRun(level + 1U));
+        if (!run->create())
+            // keep the runs as they are, they will be merged by flush()
+            return true;
+
+        // the merged runs are gone, so there is no way back on failure
+        if (!this->mergeRuns(run->writer(), first, /* withMemory */ false))
+            return false;
+
+        if (!run->finish()) {
+            std::cerr << name << ": error: failed to write a temporary file\n";
+            return false;
+        }
+
+        runs_.push_back(std::move(run));
+    }
+}
+
+/// k-way merge of the sorted runs starting at index first using a binary heap
+/// of run indexes, the defects held in memory are optionally merged, too;
+/// return false if any of the runs cannot be read completely
+template <class TItem>
+bool GenericSort<TItem>::mergeRuns(
+        AbstractWriter             *writer,
+        const size_t                first,
+        const bool                  withMemory)
+{
+    // open all the runs before anything is written
+    const size_t cnt = runs_.size() - first;
+    for (size_t i = 0U; i < cnt; ++i)
+        if (!runs_[first + i]->open())
+            return false;
+
+    TKeyList keys;
+    size_t memPos = 0U;
+    if (withMemory)
+        this->sortKeys(&keys);
+
+    // the defects held in memory are merged as the last run
+    std::vector<TItem> heads(cnt + 1U);
+    const auto readNext = [&](const size_t i) {
+        if (i < cnt)
+            return runs_[first + i]->readNext(&heads[i]);
+
+        if (keys.size() <= memPos)
+            return false;
+
+        heads[i] = std::move(cont_[keys[memPos++].idx]);
+        return true;
+    };
+
+    std::vector<size_t> heap;
+    for (size_t i = 0U; i < cnt; ++i)
+        if (readNext(i))
+            heap.push_back(i);
+
+    if (withMemory && readNext(cnt))
+        heap.push_back(cnt);
+
+    // std::*_heap() keep the greatest element on top, so the comparison is
+    // inverted; equal defects are taken from the earlier run first
+    const auto cmp = [&heads](const size_t a, const size_t b) {
+        if (heads[b] < heads[a])
+            return true;
+        if (heads[a] < heads[b])
+            return false;
+        return b < a;
+    };
+
+    std::make_heap(heap.begin(), heap.end(), cmp);
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), cmp);
+        const size_t i = heap.back();
+        writer->handleDef(std::move(heads[i]));
+
+        if (readNext(i))
+            std::push_heap(heap.begin(), heap.end(), cmp);
+        else
+            heap.pop_back();
+    }
+
+    bool ok = true;
+    for (size_t i = 0U; i < cnt; ++i) {
+        if (runs_[first + i]->hasError()) {
+            std::cerr << name << ": error: failed to read a temporary file\n";
+            ok = false;
+            break;
+        }
+    }
+
+    // the merged runs are not needed any more
+    runs_.resize(first);
+    if (withMemory)
+        cont_.clear();
+
+    return ok;
+}
+
+/// return 1 if the given file is sorted under the key, 0 if it is not sorted,
+/// -1 if it cannot be read, and -2 if it is not a regular file, which might
+/// not be possible to read twice; scan properties of the file go to *pProps
+template <class TItem>
+int GenericSort<TItem>::checkFile(
+        TScanProps                 *pProps,
+        const std::string          &fileName)
+{
+    struct stat st;
+    if (stat(fileName.c_str(), &st))
+        // the error is reported by the full sort
+        return -1;
+
+    if (!S_ISREG(st.st_mode))
+        // pipes and devices cannot be read twice
+        return -2;
+
+    try {
+        // parser errors are reported while the file is merged
+        InStream str(fileName, /* silent */ true);
+        Parser parser(str);
+
+        TItem prev, def;
+        bool sorted = true;
+        if (parser.getNext(&prev)) {
+            while (parser.getNext(&def)) {
+                if (def < prev) {
+                    sorted = false;
+                    break;
+                }
+
+                std::swap(prev, def);
+            }
+        }
+
+        if (sorted)
+            // read after the defects because of streamed JSON input
+            *pProps = parser.getScanProps();
+
+        return sorted;
+    }
+    catch (const InFileException &) {
+        return -1;
+    }
+}
+
+/// check that the files are sorted and merge them using a binary heap of file
+/// indexes, which needs to hold only one defect per file
+template <class TItem>
+bool GenericSort<TItem>::mergeFiles(
+        const TStringList          &files,
+        const bool                  silent,
+        const unsigned              jobs,
+        bool                       *pHasError)
+{
+    // check the files in parallel, they are read once more while merged
+    const size_t cnt = files.size();
+    std::vector<int> status(cnt);
+    std::vector<TScanProps> props(cnt);
+    const auto check = [this, &files, &status, &props](const size_t i) {
+        if (files[i] != "-")
+            status[i] = this->checkFile(&props[i], files[i]);
+    };
+
+    bool sorted = true;
+    const auto consume = [this, &files, &status, &props, &sorted](size_t i) {
+        if (!sorted)
+            return;
+
+        if (files[i] == "-") {
+            // the standard input cannot be read twice
+            std::cerr << name << ": warning: cannot merge standard input, "
+                "falling back to full sort\n";
+            sorted = false;
+            return;
+        }
+
+        switch (status[i]) {
+            case -2:
+                std::cerr << name << ": warning: " << files[i]
+                    << ": cannot merge input that is not a regular file, "
+                    "falling back to full sort\n";
+                sorted = false;
+                return;
+
+            case 0:
+                std::cerr << name << ": warning: " << files[i]
+                    << ": input not sorted, falling back to full sort\n";
+                // fall through!
+
+            case -1:
+                // the error is reported by the full sort
+                sorted = false;
+                return;
+        }
+
+        // use scan properties of the first file that has any
+        if (scanProps_.empty())
+            scanProps_ = props[i];
+    };
+
+    runOrdered(jobs, cnt, check, consume);
+    if (!sorted) {
+        scanProps_.clear();
+        return false;
+    }
+
+    // open all the files at once
+    std::vector<std::unique_ptr<InStream>> inputs(cnt);
+    std::vector<std::unique_ptr<Parser>> parsers(cnt);
+    for (size_t i = 0U; i < cnt; ++i) {
+        try {
+            inputs[i].reset(new InStream(files[i], silent));
+        }
+        catch (const InFileException &e) {
+            std::cerr << e.fileName << ": failed to open input file\n";
+            *pHasError = true;
+            continue;
+        }
+
+        parsers[i].reset(new Parser(*inputs[i]));
+    }
+
+    // use the same output format is the format of the first input file
+    // unless specified
+    EFileFormat format = (FF_AUTO == format_) ? FF_INVALID : format_;
+    for (size_t i = 0U; i < cnt && FF_INVALID == format; ++i)
+        if (parsers[i])
+            format = parsers[i]->inputFormat();
+
+    TWriterPtr writer = createWriter(std::cout, format, cm_, scanProps_);
+
+    std::vector<TItem> heads(cnt);
+    const auto readNext = [&parsers, &heads](const size_t i) {
+        return parsers[i] && parsers[i]->getNext(&heads[i]);
+    };
+
+    std::vector<size_t> heap;
+    for (size_t i = 0U; i < cnt; ++i)
+        if (readNext(i))
+            heap.push_back(i);
+
+    // equal defects are taken from the earlier file first, as in mergeRuns()
+    const auto cmp = [&heads](const size_t a, const size_t b) {
+        if (heads[b] < heads[a])
+            return true;
+        if (heads[a] < heads[b])
+            return false;
+        return b < a;
+    };
+
+    std::make_heap(heap.begin(), heap.end(), cmp);
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), cmp);
+        const size_t i = heap.back();
+        writer->handleDef(std::move(heads[i]));
+
+        if (readNext(i))
+            std::push_heap(heap.begin(), heap.end(), cmp);
+        else
+            heap.pop_back();
+    }
+
+    writer->flush();
+
+    for (const std::unique_ptr<Parser> &parser : parsers)
+        if (parser && parser->hasError())
+            *pHasError = true;
+
+    return true;
+}
+
+/// return false if the defects are equal, otherwise store a < b to *pResult
+inline bool cmpFileNames(bool *pResult, const Defect &a, const Defect &b)
 {
     const TEvtList &ea = a.events;
     const TEvtList &eb = b.events;
 
     // first compare the key events
-    bool result;
-    if (cmpEvents(&result, ea[a.keyEventIdx], eb[b.keyEventIdx]))
-        return result;
+    if (cmpEvents(pResult, ea[a.keyEventIdx], eb[b.keyEventIdx]))
+        return true;
 
     // the key events are incomparable, compare all events
     for (unsigned idx = 0;; ++idx) {
-        if (eb.size() <= idx)
+        if (ea.size() <= idx || eb.size() <= idx) {
             // this includes the case where the events are equal
-            return false;
+            *pResult = (ea.size() < eb.size());
+            return (ea.size() != eb.size());
+        }
 
-        if (ea.size() <= idx)
+        if (cmpEvents(pResult, ea[idx], eb[idx]))
             return true;
-
-        if (cmpEvents(&result, ea[idx], eb[idx]))
-            return result;
     }
 }
 
-struct DefByChecker: public Defect { };
-bool operator<(const DefByChecker &a, const DefByChecker &b)
+/// return the code of a ShellCheck warning, such as "1234" for "... [SC1234]"
+static boost::string_view shellCheckCode(const std::string &msg)
 {
-    // compare checker names
-    RETURN_IF_COMPARED(a, b, checker);
+    // the same as matching "^.* \\[SC([0-9]+)\\]$" but without a regex
+    const size_t len = msg.size();
+    if (!len || ']' != msg[len - 1U])
+        return boost::string_view();
+
+    size_t beg = len - 1U;
+    while (beg && isdigit(static_cast<unsigned char>(msg[beg - 1U])))
+        --beg;
+
+    const size_t digits = len - 1U - beg;
+    if (!digits || beg < 4U || msg.compare(beg - 4U, 4U, " [SC"))
+        return boost::string_view();
+
+    return boost::string_view(msg.data() + beg, digits);
+}
 
+static const Symbol shellCheckWarning("SHELLCHECK_WARNING");
+
+struct DefByChecker: public Defect { };
+
+/// compare defects after their checkers and ShellCheck codes are compared
+static bool cmpKeyEvents(bool *pResult, const Defect &a, const Defect &b)
+{
     // resolve key events
     const DefEvent &ea = a.events[a.keyEventIdx];
     const DefEvent &eb = b.events[b.keyEventIdx];
 
-    if ("SHELLCHECK_WARNING" == a.checker /* == b.checker */) {
+    // compare name of the key events
+    RETURN_BY_REF_IF_COMPARED(ea, eb, event);
+
+    return cmpFileNames(pResult, a, b);
+}
+
+bool operator<(const DefByChecker &a, const DefByChecker &b)
+{
+    // compare checker names
+    RETURN_IF_COMPARED(a, b, checker);
+
+    if (shellCheckWarning == a.checker /* == b.checker */) {
         // sort ShellCheck warnings by the [SC1234] suffixes
-        const RE reCode("^.* \\[SC([0-9]+)\\]$");
-        std::string aCode, bCode;
-        boost::smatch sm;
-        if (boost::regex_match(ea.msg, sm, reCode))
-            aCode = sm[1];
-        if (boost::regex_match(eb.msg, sm, reCode))
-            bCode = sm[1];
+        const boost::string_view aCode =
+            shellCheckCode(a.events[a.keyEventIdx].msg);
+        const boost::string_view bCode =
+            shellCheckCode(b.events[b.keyEventIdx].msg);
         if (aCode < bCode)
             return true;
         if (bCode < aCode)
             return false;
     }
 
-    // compare name of the key events
-    RETURN_IF_COMPARED(ea, eb, event);
+    bool result;
+    return cmpKeyEvents(&result, a, b)
+        && result;
+}
+
+void initKey(SortKey<DefByChecker> *pKey, const DefByChecker &def, size_t idx)
+{
+    pKey->def = &def;
+    pKey->idx = idx;
+    if (shellCheckWarning == def.checker)
+        pKey->scCode = shellCheckCode(def.events[def.keyEventIdx].msg);
+}
+
+bool operator<(const SortKey<DefByChecker> &a, const SortKey<DefByChecker> &b)
+{
+    // compare checker names
+    const DefByChecker &da = *a.def;
+    const DefByChecker &db = *b.def;
+    RETURN_IF_COMPARED(da, db, checker);
+
+    // compare ShellCheck codes, which are empty for other checkers
+    RETURN_IF_COMPARED(a, b, scCode);
+
+    bool result;
+    if (cmpKeyEvents(&result, da, db))
+        return result;
 
-    return cmpFileNames(a, b);
+    return a.idx < b.idx;
 }
 
 struct DefByPath: public Defect { };
 bool operator<(const DefByPath &a, const DefByPath &b)
 {
-    return cmpFileNames(a, b);
+    bool result;
+    return cmpFileNames(&result, a, b)
+        && result;
 }
 
-AbstractWriter* SortFactory::create(const std::string &key, const EColorMode cm)
+void initKey(SortKey<DefByPath> *pKey, const DefByPath &def, size_t idx)
+{
+    pKey->def = &def;
+    pKey->idx = idx;
+}
+
+bool operator<(const SortKey<DefByPath> &a, const SortKey<DefByPath> &b)
+{
+    bool result;
+    if (cmpFileNames(&result, *a.def, *b.def))
+        return result;
+
+    return a.idx < b.idx;
+}
+
+AbstractSort* SortFactory::create(
+        const std::string          &key,
+        const EFileFormat           format,
+        const EColorMode            cm,
+        const size_t                maxMemory,
+        const unsigned              jobs)
 {
     if (!key.compare("checker"))
-        return new GenericSort<DefByChecker>(cm);
+        return new GenericSort<DefByChecker>(format, cm, maxMemory, jobs);
 
     if (!key.compare("path"))
-        return new GenericSort<DefByPath>(cm);
+        return new GenericSort<DefByPath>(format, cm, maxMemory, jobs);
 
     // no comparator matched
     return 0;
 }
 
-static std::string name;
+/// parse size in bytes with an optional K, M, or G suffix
+static bool parseMemSize(size_t *pDst, const std::string &str)
+{
+    char *end;
+    errno = 0;
+    const unsigned long long num = strtoull(str.c_str(), &end, 10);
+    if (errno || end == str.c_str() || '-' == str[0])
+        return false;
+
+    unsigned shift = 0U;
+    switch (*end) {
+        case '\0':
+            break;
+
+        case 'K': shift = 10U; ++end; break;
+        case 'M': shift = 20U; ++end; break;
+        case 'G': shift = 30U; ++end; break;
+
+        default:
+            return false;
+    }
+
+    if (*end || ((num << shift) >> shift) != num)
+        return false;
+
+    *pDst = num << shift;
+    return true;
+}
 
 namespace po = boost::program_options;
 
@@ -167,13 +905,25 @@ int main(int argc, char *argv[])
     po::options_description desc(string("Usage: ") + name
             + " [options] [file1.err [...]], where options are");
 
-    typedef std::vector<string> TStringList;
     string key;
+    string maxMemoryStr;
+    int jobs;
 
     try {
         desc.add_options()
             ("key", po::value<string>(&key)->default_value("path"),
              "checker, path")
+            ("jobs", po::value<int>(&jobs)->default_value(1),
+             "number of input files to parse in parallel and threads to sort "
+             "the defects")
+            ("max-memory", po::value<string>(&maxMemoryStr),
+             "approximate limit for memory holding the defects (with optional "
+             "K, M, or G suffix), sorted runs of defects are written to "
+             "temporary files and merged once the limit is exceeded")
+            ("merge", "merge input files that are already sorted by the key, "
+             "fall back to full sort if any of them is not sorted")
+            ("binary-output", "write the result in the binary format instead "
+             "of the format of the input")
             ("quiet,q", "do not report any parsing errors");
 
         addColorOptions(&desc);
@@ -220,8 +970,25 @@ int main(int argc, char *argv[])
         return 1;
     }
 
+    if (jobs < 1) {
+        std::cerr << name << ": error: invalid value for --jobs: "
+            << jobs << "\n";
+        return 1;
+    }
+
+    size_t maxMemory = 0U;
+    if (vm.count("max-memory") && !parseMemSize(&maxMemory, maxMemoryStr)) {
+        std::cerr << name << ": error: invalid value for --max-memory: "
+            << maxMemoryStr << "\n";
+        return 1;
+    }
+
     SortFactory factory;
-    AbstractWriter *eng = factory.create(key, cm);
+    const EFileFormat format = (vm.count("binary-output"))
+        ? FF_BINARY
+        : FF_AUTO;
+
+    AbstractSort *eng = factory.create(key, format, cm, maxMemory, jobs);
     if (!eng) {
         std::cerr << name << ": error: unknown key: " << key << "\n\n";
         printUsage(std::cerr, desc);
@@ -232,17 +999,35 @@ int main(int argc, char *argv[])
     bool hasError = false;
 
     if (!vm.count("input-file")) {
+        if (vm.count("merge"))
+            // the same warning as for "-" given explicitly
+            std::cerr << name << ": warning: cannot merge standard input, "
+                "falling back to full sort\n";
+
         hasError = !eng->handleFile("-", silent);
     }
     else {
         const TStringList &files = vm["input-file"].as<TStringList>();
-        for (const string &fileName : files) {
-            if (!eng->handleFile(fileName, silent))
-                hasError = true;
+        if (vm.count("merge")
+                && eng->mergeFiles(files, silent, jobs, &hasError))
+        {
+            delete eng;
+            return hasError;
         }
+
+        const auto handler = [eng, &hasError](Parser &parser, size_t) {
+            if (!eng->handleFile(parser))
+                hasError = true;
+        };
+
+        if (!parseFiles(files, silent, jobs, handler))
+            hasError = true;
     }
 
     eng->flush();
+    if (eng->hasError())
+        hasError = true;
+
     delete eng;
     return hasError;
 }
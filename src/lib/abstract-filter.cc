@@ -63,3 +63,21 @@ bool PredicateFilter::matchDef(const Defect &def)
 
     return true;
 }
+
+void PredicateFilter::matchDefs(
+        std::vector<bool>          *pMatched,
+        const Defect               *defs,
+        const size_t                cnt)
+{
+    const bool neg = d->invertEach_;
+    std::vector<bool> &matched = *pMatched;
+    matched.assign(cnt, true);
+
+    // evaluate one predicate for the whole batch at a time, skip the defects
+    // already rejected by previous predicates like matchDef() does
+    for (const auto &pred : d->preds_) {
+        for (size_t i = 0U; i < cnt; ++i)
+            if (matched[i] && neg == pred->matchDef(defs[i]))
+                matched[i] = false;
+    }
+}
@@ -20,9 +20,11 @@
 #ifndef H_GUARD_ABSTRACT_FILTER_H
 #define H_GUARD_ABSTRACT_FILTER_H
 
+#include "defect-pool.hh"
 #include "writer.hh"
 
 #include <memory>
+#include <vector>
 
 /// decorator
 class GenericAbstractFilter: public AbstractWriter {
@@ -45,6 +47,18 @@ class GenericAbstractFilter: public AbstractWriter {
             agent_->handleDef(def);
         }
 
+        void handleDef(Defect &&def) override {
+            agent_->handleDef(std::move(def));
+        }
+
+        /// pass the defects one by one to handleDef(), which the derived
+        /// decorator may override.  Decorators that pass the defects through
+        /// unchanged can override this to forward the whole batch.
+        void handleDefs(Defect *defs, const size_t cnt) override {
+            for (size_t i = 0U; i < cnt; ++i)
+                this->handleDef(std::move(defs[i]));
+        }
+
         void flush() override {
             agent_->flush();
         }
@@ -63,10 +77,22 @@ class GenericAbstractFilter: public AbstractWriter {
 class AbstractFilter: public GenericAbstractFilter {
     private:
         bool neg_ = false;
+        std::vector<bool> matched_;
 
     protected:
         virtual bool matchDef(const Defect &def) = 0;
 
+        /// evaluate matchDef() for each defect of the batch and store the
+        /// results to *pMatched, can be overridden to evaluate it column-wise
+        virtual void matchDefs(
+                std::vector<bool>      *pMatched,
+                const Defect           *defs,
+                const size_t            cnt)
+        {
+            for (size_t i = 0U; i < cnt; ++i)
+                (*pMatched)[i] = this->matchDef(defs[i]);
+        }
+
     public:
         AbstractFilter(AbstractWriter *agent):
             GenericAbstractFilter(agent)
@@ -83,6 +109,67 @@ class AbstractFilter: public GenericAbstractFilter {
 
             agent_->handleDef(def);
         }
+
+        void handleDef(Defect &&def) override {
+            if (neg_ == matchDef(def))
+                return;
+
+            agent_->handleDef(std::move(def));
+        }
+
+        void handleDefs(Defect *defs, const size_t cnt) override {
+            matched_.assign(cnt, false);
+            this->matchDefs(&matched_, defs, cnt);
+
+            // move the defects we keep to the front of the batch
+            size_t dst = 0U;
+            for (size_t i = 0U; i < cnt; ++i) {
+                if (neg_ == matched_[i])
+                    continue;
+
+                if (dst != i)
+                    std::swap(defs[dst], defs[i]);
+                ++dst;
+            }
+
+            if (dst)
+                agent_->handleDefs(defs, dst);
+        }
+};
+
+/// decorator that modifies each defect in place
+class AbstractTransformer: public GenericAbstractFilter {
+    protected:
+        virtual void transformDef(Defect *pDef) = 0;
+
+        DefPool                         defPool_;
+
+    private:
+        Defect                          defCopy_;
+
+    public:
+        AbstractTransformer(AbstractWriter *agent):
+            GenericAbstractFilter(agent)
+        {
+        }
+
+        void handleDef(const Defect &defOrig) override {
+            // transform a copy kept in memory reused for each defect
+            defPool_.assign(&defCopy_, defOrig);
+            this->handleDef(std::move(defCopy_));
+        }
+
+        void handleDef(Defect &&def) override {
+            this->transformDef(&def);
+            agent_->handleDef(std::move(def));
+        }
+
+        void handleDefs(Defect *defs, const size_t cnt) override {
+            for (size_t i = 0U; i < cnt; ++i)
+                this->transformDef(&defs[i]);
+
+            agent_->handleDefs(defs, cnt);
+        }
 };
 
 class IPredicate {
@@ -104,6 +191,12 @@ class PredicateFilter: public AbstractFilter {
     protected:
         bool matchDef(const Defect &def) override;
 
+        void matchDefs(
+                std::vector<bool>      *pMatched,
+                const Defect           *defs,
+                size_t                  cnt)
+            override;
+
     private:
         struct Private;
         std::unique_ptr<Private> d;
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2023 Red Hat, Inc.
+ *
+ * This file is part of csdiff.
+ *
+ * csdiff is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * csdiff is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with csdiff.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Replacement of the global operator new/delete that counts heap allocations
+// and prints the totals on exit.  It is linked only if csdiff is configured
+// with -DALLOC_COUNTER=ON.  Comparing the totals for inputs of different size
+// shows how many allocations are made per defect.
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<unsigned long> allocCount;
+static std::atomic<unsigned long> allocBytes;
+
+static void* countedAlloc(const size_t size) noexcept
+{
+    allocCount.fetch_add(1U, std::memory_order_relaxed);
+    allocBytes.fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1U);
+}
+
+void* operator new(const size_t size)
+{
+    void *ptr = countedAlloc(size);
+    if (!ptr)
+        throw std::bad_alloc();
+
+    return ptr;
+}
+
+void* operator new[](const size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(const size_t size, const std::nothrow_t &) noexcept
+{
+    return countedAlloc(size);
+}
+
+void* operator new[](const size_t size, const std::nothrow_t &) noexcept
+{
+    return countedAlloc(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept
+{
+    std::free(ptr);
+}
+
+struct AllocReporter {
+    ~AllocReporter() {
+        // std::cerr might be already destroyed at this point
+        std::fprintf(stderr, "alloc-counter: %lu allocations, %lu bytes\n",
+                allocCount.load(), allocBytes.load());
+    }
+};
+
+static AllocReporter reporter;
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2023 Red Hat, Inc.
+ *
+ * This file is part of csdiff.
+ *
+ * csdiff is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * csdiff is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with csdiff.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef H_GUARD_BINARY_FORMAT_H
+#define H_GUARD_BINARY_FORMAT_H
+
+#include <cstdint>
+
+// Compact binary format for passing defects between csdiff tools.
+//
+// The stream starts with the magic bytes and the format version, followed
+// by a sequence of records.  Each record starts with a single-byte tag:
+//
+//  - TAG_SCAN_PROPS: number of properties, followed by (key, value) pairs
+//  - TAG_DEFECT: checker, annotation, function, language, tool, keyEventIdx,
+//    cwe, imp, defectId, number of events, followed by the events, each of
+//    them encoded as fileName, line, column, event, msg, verbosityLevel
+//  - TAG_END: end of the stream, everything after it is ignored
+//
+// Integers are encoded as LEB128 varints, signed integers are zig-zag encoded
+// first.  Strings of the fields with few distinct values (checker, language,
+// tool, fileName, event, and keys of scan properties) are deduplicated using
+// a string table built incrementally by both sides.  Each of them is encoded
+// as a varint N.  If N is zero, the length of a new string and its bytes
+// follow and the string is appended to the string table.  Otherwise, N-1 is
+// an index to the string table.  The other strings (annotation, function,
+// msg, and values of scan properties) are encoded inline as their length
+// followed by their bytes, so that the string table does not grow with the
+// size of the stream.
+
+namespace BinaryFormat {
+
+/// starts with a non-ASCII byte so that it cannot be mistaken for text
+constexpr char magic[] = "\x89" "CSB\r\n\x1a\n";
+constexpr unsigned magicSize = sizeof(magic) - 1U;
+
+const uint64_t version = 2U;
+
+enum ETag {
+    TAG_END         = 'E',
+    TAG_DEFECT      = 'D',
+    TAG_SCAN_PROPS  = 'P'
+};
+
+inline uint64_t zigZagEncode(const int64_t num)
+{
+    return (static_cast<uint64_t>(num) << 1) ^ static_cast<uint64_t>(num >> 63);
+}
+
+inline int64_t zigZagDecode(const uint64_t num)
+{
+    return static_cast<int64_t>(num >> 1) ^ -static_cast<int64_t>(num & 1U);
+}
+
+} // namespace BinaryFormat
+
+#endif /* H_GUARD_BINARY_FORMAT_H */
@@ -20,10 +20,17 @@
 #include "csdiff-core.hh"
 
 #include "deflookup.hh"
+#include "parallel.hh"
 #include "writer-cov.hh"
+#include "writer-json-common.hh"
+#include "writer-json-simple.hh"
 #include "writer-json.hh"
 
+#include <atomic>
+#include <fstream>
 #include <memory>
+#include <sstream>
+#include <thread>
 
 // FIXME: some keys should be merge more intelligently if they already exist
 // TODO: define a nesting limit for keys like diffbase-diffbase-diffbase-...
@@ -38,14 +45,248 @@ void mergeScanProps(TScanProps &props, const TScanProps &oldProps)
     }
 }
 
+using TDefList = DefLookup::TDefList;
+
+/// return true if def is an internal warning that should not be reported
+static bool isHiddenDefect(const Defect &def, const bool showInternal)
+{
+    if (showInternal)
+        return false;
+
+    // we suppress internal warnings by default
+    const DefEvent &keyEvt = def.events[def.keyEventIdx];
+    return (keyEvt.event == "internal warning");
+}
+
+/// return true if def from the new scan has no match in the old scan
+static bool isNewDefect(
+        DefLookup                  &stor,
+        const Defect               &def,
+        const bool                  showInternal)
+{
+    if (stor.lookup(def))
+        return false;
+
+    // a newly added defect found
+    return !isHiddenDefect(def, showInternal);
+}
+
+/// index the old scan by a separate thread while the new scan is parsed, then
+/// look up the new defects by up to jobs threads, each of them handling the
+/// checkers of one shard of the index.  A defect can match only defects of its
+/// own checker, so the result is the same as if the lookups ran sequentially.
+static void diffScansParallel(
+        TDefList                   *pAdded,
+        Parser                     &pOld,
+        Parser                     &pNew,
+        const bool                  showInternal,
+        const unsigned              jobs)
+{
+    const size_t shardCnt = jobs;
+    std::vector<DefLookup> shards(shardCnt, DefLookup(showInternal));
+
+    std::thread indexer([&pOld, &shards, shardCnt]() {
+        Defect def;
+        while (pOld.getNext(&def))
+            shards[def.checker.hash() % shardCnt].hashDefect(def);
+    });
+
+    // buffer the new defects and remember their indexes per shard
+    std::vector<Defect> defList;
+    std::vector<std::vector<size_t>> idxByShard(shardCnt);
+    Defect def;
+    while (pNew.getNext(&def)) {
+        idxByShard[def.checker.hash() % shardCnt].push_back(defList.size());
+        defList.push_back(std::move(def));
+    }
+
+    indexer.join();
+
+    // defects of each shard are looked up in their original order because
+    // DefLookup::lookup() consumes the matched entries
+    std::vector<char> isNew(defList.size(), false);
+    const auto lookup = [&](const size_t shard) {
+        DefLookup &stor = shards[shard];
+        for (const size_t idx : idxByShard[shard])
+            isNew[idx] = isNewDefect(stor, defList[idx], showInternal);
+    };
+
+    runOrdered(jobs, shardCnt, lookup, [](size_t) { });
+
+    // keep the new defects in the order of the new scan
+    const size_t cnt = defList.size();
+    for (size_t idx = 0U; idx < cnt; ++idx)
+        if (isNew[idx])
+            pAdded->push_back(std::move(defList[idx]));
+}
+
+/// index the new scan, which is smaller than the old one, and stream the old
+/// scan through the index, counting only the defects that may match.  Then
+/// look up the new defects in their original order as diffScans() would do.
+static void diffScansIndexNew(
+        TDefList                   *pAdded,
+        Parser                     &pOld,
+        Parser                     &pNew,
+        const bool                  showInternal)
+{
+    DefLookup stor(showInternal);
+    std::vector<Defect> defList;
+    Defect def;
+    while (pNew.getNext(&def)) {
+        stor.watchDefect(def);
+        defList.push_back(std::move(def));
+    }
+
+    while (pOld.getNext(&def))
+        stor.hashWatchedDefect(def);
+
+    for (Defect &defNew : defList)
+        if (isNewDefect(stor, defNew, showInternal))
+            pAdded->push_back(std::move(defNew));
+}
+
+/// pass scan properties of both scans to the writer if they have changed
+static void updateScanProps(
+        AbstractWriter             *writer,
+        TScanProps                 *pProps,
+        const Parser               &pNew,
+        const TScanProps           &oldProps)
+{
+    TScanProps props = pNew.getScanProps();
+    mergeScanProps(props, oldProps);
+    if (props == *pProps)
+        return;
+
+    writer->setScanProps(props);
+    pProps->swap(props);
+}
+
+/// write the defects of the new scan that have no match in stor.  If scan
+/// properties of the new scan may still follow its defects, the added defects
+/// are buffered until the properties are complete so that the writer does not
+/// write its header too early.
+static void writeNewDefects(
+        AbstractWriter             *writer,
+        TScanProps                 *pProps,
+        DefLookup                  &stor,
+        Parser                     &pNew,
+        const TScanProps           &oldProps,
+        const bool                  showInternal)
+{
+    const bool buffer = !pNew.scanPropsFinal();
+    TDefList added;
+    Defect def;
+    while (pNew.getNext(&def)) {
+        if (!isNewDefect(stor, def, showInternal))
+            continue;
+
+        if (buffer)
+            added.push_back(std::move(def));
+        else
+            writer->handleDef(std::move(def));
+    }
+
+    // streamed JSON input may carry scan properties after the defects
+    updateScanProps(writer, pProps, pNew, oldProps);
+
+    for (Defect &defNew : added)
+        writer->handleDef(std::move(defNew));
+}
+
+/// return size of the data that remain to be read, zero if not known
+static size_t inputSize(InStream &input)
+{
+    boost::string_view data;
+    return (input.mappedData(&data))
+        ? data.size()
+        : 0U;
+}
+
+static bool /* anyError */ diffLookup(
+        std::ostream               &strDst,
+        DefLookup                  &stor,
+        const TScanProps           &oldProps,
+        InStream                   &strNew,
+        bool                        showInternal,
+        EFileFormat                 format,
+        EColorMode                  cm);
+
+/// diff the new scan against a baseline index written by buildIndex()
+static bool /* anyError */ diffIndex(
+        std::ostream               &strDst,
+        InStream                   &strIdx,
+        InStream                   &strNew,
+        const bool                  showInternal,
+        EFileFormat                 format,
+        const EColorMode            cm)
+{
+    DefLookup stor(showInternal);
+    TScanProps oldProps;
+    if (!stor.readIndex(strIdx, &oldProps))
+        return true;
+
+    return diffLookup(strDst, stor, oldProps, strNew, showInternal, format, cm);
+}
+
+/// diff the new scan against the given DefLookup of the old scan
+static bool /* anyError */ diffLookup(
+        std::ostream               &strDst,
+        DefLookup                  &stor,
+        const TScanProps           &oldProps,
+        InStream                   &strNew,
+        const bool                  showInternal,
+        EFileFormat                 format,
+        const EColorMode            cm)
+{
+    Parser pNew(strNew);
+
+    // propagate scan properties if available
+    TScanProps props = pNew.getScanProps();
+    mergeScanProps(props, oldProps);
+
+    // decide which format use for the output
+    if (format == FF_AUTO)
+        format = pNew.inputFormat();
+
+    TWriterPtr writer = createWriter(strDst, format, cm, props);
+    writeNewDefects(writer.get(), &props, stor, pNew, oldProps, showInternal);
+    writer->flush();
+
+    return pNew.hasError();
+}
+
 bool /* anyError */ diffScans(
         std::ostream               &strDst,
         InStream                   &strOld,
         InStream                   &strNew,
         const bool                  showInternal,
         EFileFormat                 format,
-        const EColorMode            cm)
+        const EColorMode            cm,
+        const unsigned              jobs)
 {
+    if (DefLookup::isIndex(strNew)) {
+        strNew.handleError("an index can be used only as the old scan");
+        return true;
+    }
+
+    if (DefLookup::isIndex(strOld))
+        // the baseline has already been parsed and hashed
+        return diffIndex(strDst, strOld, strNew, showInternal, format, cm);
+
+    // index the smaller scan if the sizes of both inputs are known
+    const size_t sizeNew = inputSize(strNew);
+    const bool indexNew = sizeNew && sizeNew < inputSize(strOld);
+    const bool sequential = !indexNew && jobs < 2U;
+
+    // diagnostic messages of the parsers are printed once both scans are read
+    // so that they do not interleave when the scans are parsed concurrently,
+    // and so that they come in the same order if the new scan is read first
+    std::ostringstream errOld, errNew;
+    if (!sequential) {
+        strOld.setErrStr(&errOld);
+        strNew.setErrStr(&errNew);
+    }
+
     // create Parsers
     Parser pOld(strOld);
     Parser pNew(strNew);
@@ -61,30 +302,284 @@ bool /* anyError */ diffScans(
     // create the appropriate writer
     TWriterPtr writer = createWriter(strDst, format, cm, props);
 
-    // read old
-    DefLookup stor(/* TODO: document this side effect */ showInternal);
+    if (!sequential) {
+        TDefList added;
+        if (indexNew)
+            diffScansIndexNew(&added, pOld, pNew, showInternal);
+        else
+            diffScansParallel(&added, pOld, pNew, showInternal, jobs);
+
+        std::cerr << errOld.str() << errNew.str();
+        strOld.setErrStr(&std::cerr);
+        strNew.setErrStr(&std::cerr);
+
+        // both scans have been read completely, including any scan properties
+        // that follow the defects in streamed JSON input
+        updateScanProps(writer.get(), &props, pNew, pOld.getScanProps());
+        for (Defect &def : added)
+            writer->handleDef(std::move(def));
+    }
+    else {
+        // read old
+        DefLookup stor(/* TODO: document this side effect */ showInternal);
+        Defect def;
+        while (pOld.getNext(&def))
+            stor.hashDefect(def);
+
+        // the old scan has been read completely, so its scan properties are
+        // available even if they follow the defects in streamed JSON input
+        const TScanProps &oldProps = pOld.getScanProps();
+        updateScanProps(writer.get(), &props, pNew, oldProps);
+
+        // read new
+        writeNewDefects(writer.get(), &props, stor, pNew, oldProps,
+                showInternal);
+    }
+
+    writer->flush();
+
+    return pOld.hasError()
+        || pNew.hasError();
+}
+
+bool /* anyError */ diffScansUnion(
+        std::ostream                       &strDst,
+        const std::vector<std::string>     &oldFiles,
+        InStream                           &strNew,
+        const bool                          showInternal,
+        const EFileFormat                   format,
+        const EColorMode                    cm,
+        const unsigned                      jobs)
+{
+    if (DefLookup::isIndex(strNew)) {
+        strNew.handleError("an index can be used only as the old scan");
+        return true;
+    }
+
+    // hash all the old scans into a single DefLookup, the counts of equal
+    // keys add up as if the old scans were concatenated
+    DefLookup stor(showInternal);
+    TScanProps oldProps;
+    bool anyError = false;
+
+    const auto hashOld = [&](Parser &pOld, size_t) {
+        Defect def;
+        while (pOld.getNext(&def))
+            stor.hashDefect(def);
+
+        // take the scan properties of the first old scan that has any
+        if (oldProps.empty())
+            oldProps = pOld.getScanProps();
+
+        if (pOld.hasError())
+            anyError = true;
+    };
+
+    // DefLookup::readIndex() cannot add up an index with other old scans
+    std::atomic<bool> anyIndex(false);
+    const auto rejectIndex = [&anyIndex](InStream &input, size_t) {
+        if (!DefLookup::isIndex(input))
+            return true;
+
+        input.handleError("an index cannot be used with multiple old scans");
+        anyIndex = true;
+        return false;
+    };
+
+    if (!parseFiles(oldFiles, strNew.silent(), jobs, hashOld, rejectIndex))
+        anyError = true;
+
+    if (anyIndex)
+        return true;
+
+    return diffLookup(strDst, stor, oldProps, strNew, showInternal, format, cm)
+        || anyError;
+}
+
+bool /* anyError */ buildIndex(std::ostream &strDst, InStream &strBase)
+{
+    Parser pBase(strBase);
+    DefLookup stor;
     Defect def;
-    while (pOld.getNext(&def))
+    while (pBase.getNext(&def))
         stor.hashDefect(def);
 
-    // read new
-    while (pNew.getNext(&def)) {
-        if (stor.lookup(def))
-            continue;
+    if (!stor.writeIndex(strDst, pBase.getScanProps())) {
+        std::cerr << "error: failed to write the index file\n";
+        return true;
+    }
 
-        if (!showInternal) {
-            const DefEvent &keyEvt = def.events[def.keyEventIdx];
-            if (keyEvt.event == "internal warning")
-                // we suppress internal warnings by default
-                continue;
+    return pBase.hasError();
+}
+
+/// write the defects of defList that are flagged in the given list
+static void writeDiff(
+        std::ostream               &strDst,
+        const EFileFormat           format,
+        const EColorMode            cm,
+        const TScanProps           &props,
+        TDefList                   &defList,
+        const std::vector<bool>    &flags,
+        const bool                  showInternal)
+{
+    TWriterPtr writer = createWriter(strDst, format, cm, props);
+    for (size_t i = 0U; i < defList.size(); ++i)
+        if (flags[i] && !isHiddenDefect(defList[i], showInternal))
+            writer->handleDef(std::move(defList[i]));
+
+    writer->flush();
+}
+
+/// serialize the defects of defList that are flagged in the given list
+static boost::json::array jsonSerializeDiff(
+        const TDefList             &defList,
+        const std::vector<bool>    &flags,
+        const bool                  showInternal)
+{
+    boost::json::array defNodes;
+    for (size_t i = 0U; i < defList.size(); ++i)
+        if (flags[i] && !isHiddenDefect(defList[i], showInternal))
+            defNodes.push_back(jsonSerializeDefect(defList[i]));
+
+    return defNodes;
+}
+
+bool /* anyError */ diffScansBoth(
+        std::ostream               &strAdded,
+        std::ostream               *pStrFixed,
+        InStream                   &strOld,
+        InStream                   &strNew,
+        const bool                  showInternal,
+        const EFileFormat           format,
+        const EColorMode            cm)
+{
+    for (InStream *pStr : { &strOld, &strNew }) {
+        if (DefLookup::isIndex(*pStr)) {
+            pStr->handleError("an index cannot be used to find fixed defects");
+            return true;
         }
+    }
+
+    Parser pOld(strOld);
+    Parser pNew(strNew);
+
+    // both scans are kept in memory, fixed defects are written in their order
+    TDefList oldDefs, newDefs;
+    Defect def;
+    while (pOld.getNext(&def))
+        oldDefs.push_back(std::move(def));
+    while (pNew.getNext(&def))
+        newDefs.push_back(std::move(def));
+
+    // the inputs are completely read, so scan properties are available even
+    // if they follow the defects in streamed JSON input
+    TScanProps propsAdded = pNew.getScanProps();
+    mergeScanProps(propsAdded, pOld.getScanProps());
 
-        // a newly added defect found
-        writer->handleDef(def);
+    std::vector<bool> isAdded, isFixed;
+    DefLookup::diffBoth(&isAdded, &isFixed, oldDefs, newDefs, showInternal);
+
+    if (pStrFixed) {
+        // use the same format and scan properties as two separate runs would
+        TScanProps propsFixed = pOld.getScanProps();
+        mergeScanProps(propsFixed, pNew.getScanProps());
+
+        const EFileFormat fmtAdded = (FF_AUTO == format)
+            ? pNew.inputFormat()
+            : format;
+        const EFileFormat fmtFixed = (FF_AUTO == format)
+            ? pOld.inputFormat()
+            : format;
+
+        writeDiff(strAdded, fmtAdded, cm, propsAdded, newDefs, isAdded,
+                showInternal);
+        writeDiff(*pStrFixed, fmtFixed, cm, propsFixed, oldDefs, isFixed,
+                showInternal);
     }
+    else {
+        // { "scan": { ... }, "added": [ ... ], "fixed": [ ... ] }
+        boost::json::object root;
+        if (!propsAdded.empty())
+            root["scan"] = jsonSerializeScanProps(propsAdded);
 
-    writer->flush();
+        root["added"] = jsonSerializeDiff(newDefs, isAdded, showInternal);
+        root["fixed"] = jsonSerializeDiff(oldDefs, isFixed, showInternal);
+        jsonPrettyPrint(strAdded, root);
+    }
 
     return pOld.hasError()
         || pNew.hasError();
 }
+
+bool /* anyError */ diffScansBatch(
+        InStream                           &strOld,
+        const std::vector<std::string>     &newFiles,
+        const std::vector<std::string>     &outFiles,
+        const bool                          showInternal,
+        const EFileFormat                   format,
+        const EColorMode                    cm,
+        const unsigned                      jobs)
+{
+    // hash the old scan only once
+    DefLookup stor(showInternal);
+    TScanProps oldProps;
+    bool anyError = false;
+    if (DefLookup::isIndex(strOld)) {
+        if (!stor.readIndex(strOld, &oldProps))
+            return true;
+    }
+    else {
+        Parser pOld(strOld);
+        Defect def;
+        while (pOld.getNext(&def))
+            stor.hashDefect(def);
+
+        oldProps = pOld.getScanProps();
+        anyError = pOld.hasError();
+    }
+
+    // diagnostic messages are printed in the order of the new scans
+    const size_t cnt = newFiles.size();
+    std::vector<std::ostringstream> errStrs(cnt);
+    std::vector<char> errors(cnt, false);
+
+    const auto diffOne = [&](const size_t i) {
+        std::ostream &errStr = errStrs[i];
+        try {
+            InStream strNew(newFiles[i], strOld.silent());
+            strNew.setErrStr(&errStr);
+
+            std::ofstream strDst(outFiles[i]);
+            if (!strDst) {
+                errStr << outFiles[i] << ": failed to open output file\n";
+                errors[i] = true;
+                return;
+            }
+
+            // DefLookup::lookup() consumes the matched defects, so each new
+            // scan needs its own copy, which shares the hash tables
+            DefLookup storCopy(stor);
+            errors[i] = diffLookup(strDst, storCopy, oldProps, strNew,
+                    showInternal, format, cm);
+
+            strDst.close();
+            if (strDst.fail()) {
+                errStr << outFiles[i] << ": failed to write output file\n";
+                errors[i] = true;
+            }
+        }
+        catch (const InFileException &e) {
+            errStr << e.fileName << ": failed to open input file\n";
+            errors[i] = true;
+        }
+    };
+
+    const auto report = [&](const size_t i) {
+        std::cerr << errStrs[i].str();
+        if (errors[i])
+            anyError = true;
+    };
+
+    runOrdered(jobs, cnt, diffOne, report);
+    return anyError;
+}
@@ -21,10 +21,56 @@
 #include "instream.hh"
 #include "parser.hh"
 
+#include <string>
+#include <vector>
+
 bool /* anyError */ diffScans(
         std::ostream               &strDst,
         InStream                   &strOld,
         InStream                   &strNew,
         bool                        showInternal= false,
         EFileFormat                 format      = FF_AUTO,
+        EColorMode                  cm          = CM_AUTO,
+        unsigned                    jobs        = 1U);
+
+/// diff the new scan against the union of the given old scans, which are
+/// hashed into a single DefLookup.  The result is the same as if the old scans
+/// were concatenated into one.  Up to jobs old scans are parsed in parallel.
+bool /* anyError */ diffScansUnion(
+        std::ostream                       &strDst,
+        const std::vector<std::string>     &oldFiles,
+        InStream                           &strNew,
+        bool                                showInternal= false,
+        EFileFormat                         format      = FF_AUTO,
+        EColorMode                          cm          = CM_AUTO,
+        unsigned                            jobs        = 1U);
+
+/// diff the scans in both directions at once, write the added defects to
+/// strAdded and the fixed defects to *pStrFixed.  If pStrFixed is nullptr,
+/// write a single JSON document with "added" and "fixed" sections to strAdded.
+bool /* anyError */ diffScansBoth(
+        std::ostream               &strAdded,
+        std::ostream               *pStrFixed,
+        InStream                   &strOld,
+        InStream                   &strNew,
+        bool                        showInternal= false,
+        EFileFormat                 format      = FF_AUTO,
         EColorMode                  cm          = CM_AUTO);
+
+/// diff each of the new scans against the same old scan, which is parsed and
+/// hashed only once, and write the result for newFiles[i] to outFiles[i].  Up
+/// to jobs new scans are processed in parallel.
+bool /* anyError */ diffScansBatch(
+        InStream                           &strOld,
+        const std::vector<std::string>     &newFiles,
+        const std::vector<std::string>     &outFiles,
+        bool                                showInternal= false,
+        EFileFormat                         format      = FF_AUTO,
+        EColorMode                          cm          = CM_AUTO,
+        unsigned                            jobs        = 1U);
+
+/// parse the baseline scan and write its index file, which can be given to
+/// diffScans() as the old scan to skip parsing and filtering of the baseline
+bool /* anyError */ buildIndex(
+        std::ostream               &strDst,
+        InStream                   &strBase);
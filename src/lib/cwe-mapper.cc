@@ -149,23 +149,19 @@ struct CweMapDecorator::Private {
 };
 
 CweMapDecorator::CweMapDecorator(AbstractWriter *writer, bool silent):
-    GenericAbstractFilter(writer),
+    AbstractTransformer(writer),
     d(new Private)
 {
     d->cweMap.setSilent(silent);
 }
 
-void CweMapDecorator::handleDef(const Defect &orig)
+void CweMapDecorator::transformDef(Defect *pDef)
 {
-    if (d->cweMap.empty()) {
+    if (d->cweMap.empty())
         // CweMap not populated
-        agent_->handleDef(orig);
         return;
-    }
 
-    Defect def(orig);
-    d->cweMap.assignCwe(def);
-    agent_->handleDef(def);
+    d->cweMap.assignCwe(*pDef);
 }
 
 CweMap& CweMapDecorator::cweMap()
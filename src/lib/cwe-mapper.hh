@@ -41,16 +41,17 @@ class CweMap: public AbstractCsvParser {
         std::unique_ptr<Private> d;
 };
 
-class CweMapDecorator: public GenericAbstractFilter {
+class CweMapDecorator: public AbstractTransformer {
     public:
         /// @param writer the instance will be deleted on destruction
         CweMapDecorator(AbstractWriter *writer, bool silent);
         ~CweMapDecorator() override = default;
 
-        void handleDef(const Defect &def) override;
-
         CweMap& cweMap();
 
+    protected:
+        void transformDef(Defect *pDef) override;
+
     private:
         struct Private;
         std::unique_ptr<Private> d;
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2023 Red Hat, Inc.
+ *
+ * This file is part of csdiff.
+ *
+ * csdiff is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * csdiff is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with csdiff.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef H_GUARD_DEFECT_POOL_H
+#define H_GUARD_DEFECT_POOL_H
+
+#include "defect.hh"
+
+#include <algorithm>
+
+/// Pool of events dropped from defects.  When a Defect object is reused for
+/// the next defect, its strings and events keep their memory, and the events
+/// that do not fit into the next defect are moved to the pool instead of
+/// being freed.  Once the pool is warm, filling a defect does not allocate.
+class DefPool {
+    public:
+        /// resize the list of events, the events taken from the pool are in
+        /// an unspecified state and need to be overwritten by the caller
+        void resizeEvents(TEvtList *pEvtList, const size_t size) {
+            while (size < pEvtList->size()) {
+                if (spare_.size() < maxSpare)
+                    spare_.push_back(std::move(pEvtList->back()));
+
+                pEvtList->pop_back();
+            }
+
+            while (pEvtList->size() < size) {
+                if (spare_.empty()) {
+                    pEvtList->emplace_back();
+                    continue;
+                }
+
+                pEvtList->push_back(std::move(spare_.back()));
+                spare_.pop_back();
+            }
+        }
+
+        /// append an empty event to the list of events
+        DefEvent& appendEvent(TEvtList *pEvtList) {
+            this->resizeEvents(pEvtList, pEvtList->size() + 1U);
+            DefEvent &evt = pEvtList->back();
+            evt.fileName = Symbol();
+            evt.line = 0;
+            evt.column = 0;
+            evt.event = Symbol();
+            evt.msg.clear();
+            evt.verbosityLevel = 0;
+            return evt;
+        }
+
+        /// reset *pDef to the state of Defect() but keep its memory
+        void reset(Defect *pDef) {
+            pDef->checker = Symbol();
+            pDef->annotation.clear();
+            this->resizeEvents(&pDef->events, 0U);
+            pDef->keyEventIdx = 0U;
+            pDef->cwe = 0;
+            pDef->imp = 0;
+            pDef->defectId = 0;
+            pDef->function.clear();
+            pDef->language.clear();
+            pDef->tool.clear();
+        }
+
+        /// make *pDst a copy of src but keep the memory of *pDst
+        void assign(Defect *pDst, const Defect &src) {
+            if (pDst == &src)
+                return;
+
+            pDst->checker = src.checker;
+            pDst->annotation = src.annotation;
+            this->resizeEvents(&pDst->events, src.events.size());
+            std::copy(src.events.begin(), src.events.end(),
+                    pDst->events.begin());
+            pDst->keyEventIdx = src.keyEventIdx;
+            pDst->cwe = src.cwe;
+            pDst->imp = src.imp;
+            pDst->defectId = src.defectId;
+            pDst->function = src.function;
+            pDst->language = src.language;
+            pDst->tool = src.tool;
+        }
+
+    private:
+        /// bound for the case where events are taken from another pool
+        static constexpr size_t     maxSpare = 0x400;
+
+        TEvtList                    spare_;
+};
+
+#endif /* H_GUARD_DEFECT_POOL_H */
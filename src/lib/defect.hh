@@ -20,6 +20,8 @@
 #ifndef H_GUARD_DEFECT_H
 #define H_GUARD_DEFECT_H
 
+#include "symbol.hh"
+
 #include <map>
 #include <string>
 #include <vector>
@@ -45,10 +47,10 @@
 
 
 struct DefEvent {
-    std::string         fileName;
+    Symbol              fileName;
     int                 line            = 0;
     int                 column          = 0;
-    std::string         event;
+    Symbol              event;
     std::string         msg;
 
     /// 0 = key event,  1 = info event,  2 = trace event
@@ -56,7 +58,7 @@ struct DefEvent {
 
     DefEvent() { }
 
-    explicit DefEvent(const std::string &event):
+    explicit DefEvent(const Symbol &event):
         event(event)
     {
     }
@@ -85,7 +87,7 @@ inline bool operator<(const DefEvent &a, const DefEvent &b)
 typedef std::vector<DefEvent> TEvtList;
 
 struct Defect {
-    std::string         checker;
+    Symbol              checker;
     std::string         annotation;
     TEvtList            events;
     unsigned            keyEventIdx = 0U;   ///< in range 0..(events.size()-1)
@@ -98,7 +100,7 @@ struct Defect {
 
     Defect() { }
 
-    explicit Defect(const std::string &checker):
+    explicit Defect(const Symbol &checker):
         checker(checker)
     {
     }
@@ -22,19 +22,323 @@
 #include "msg-filter.hh"
 #include "parser.hh"
 
-#include <map>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
 
-typedef std::vector<Defect>                     TDefList;
-typedef std::map<std::string, TDefList>         TDefByMsg;
-typedef std::map<std::string, TDefByMsg>        TDefByEvt;
-typedef std::map<std::string, TDefByEvt>        TDefByFile;
-typedef std::map<std::string, TDefByFile>       TDefByChecker;
+/// 64-bit FNV-1a hash of str, chained from the given hash value
+static inline uint64_t hashChain(uint64_t hash, const std::string &str)
+{
+    static const uint64_t prime = 0x100000001b3ULL;
+    for (const unsigned char c : str) {
+        hash ^= c;
+        hash *= prime;
+    }
+
+    // mix in the length so that ("ab", "c") and ("a", "bc") hash differently
+    hash ^= str.size();
+    hash *= prime;
+    return hash;
+}
+
+/// chain the precomputed hash of an interned string
+static inline uint64_t hashChain(uint64_t hash, const Symbol &sym)
+{
+    hash ^= sym.hash();
+    hash *= 0x100000001b3ULL;
+    return hash;
+}
+
+static const uint64_t hashInit = 0xcbf29ce484222325ULL;
+
+/// (checker, path) pair used to look up the "internal warning" flag
+struct PathKey {
+    Symbol                          checker;
+    Symbol                          path;
+};
+
+inline bool operator==(const PathKey &a, const PathKey &b)
+{
+    return a.checker == b.checker
+        && a.path == b.path;
+}
+
+/// normalized key of a defect used for matching
+struct DefKey {
+    PathKey                         pk;
+    Symbol                          event;
+    std::string                     msg;
+};
+
+inline bool operator==(const DefKey &a, const DefKey &b)
+{
+    return a.pk == b.pk
+        && a.event == b.event
+        && a.msg == b.msg;
+}
+
+/// open-addressing hash map with linear probing and precomputed hashes
+template <class TKey, class TVal>
+class FlatHashMap {
+    public:
+        /// return the value stored for key, or nullptr if there is none
+        TVal* find(const TKey &key, const uint64_t hash)
+        {
+            const uint32_t ent = this->findEntry(key, hash);
+            if (!ent)
+                return nullptr;
+
+            return &entries_[ent - 1].second;
+        }
+
+        /// return the number of the entry holding key, zero if there is none,
+        /// entries keep their numbers when new entries are inserted
+        uint32_t findEntry(const TKey &key, const uint64_t hash) const
+        {
+            if (slots_.empty())
+                return 0U;
+
+            return slots_[this->findSlot(key, hash)].ent;
+        }
+
+        /// return the value of the entry returned by findEntry()
+        TVal& valueAt(const uint32_t ent)
+        {
+            return entries_[ent - 1].second;
+        }
+
+        const TVal& valueAt(const uint32_t ent) const
+        {
+            return entries_[ent - 1].second;
+        }
+
+        /// return the value stored for key, value-initialize it if missing
+        TVal& lookupOrInsert(const TKey &key, const uint64_t hash)
+        {
+            // keep the load factor at or below 1/2
+            if (slots_.size() < 2U * (entries_.size() + 1U))
+                this->rehash(slots_.empty() ? 16U : 2U * slots_.size());
+
+            const size_t idx = this->findSlot(key, hash);
+            TSlot &slot = slots_[idx];
+            if (!slot.ent) {
+                entries_.emplace_back(key, TVal());
+                slot.hash = hash;
+                slot.ent = entries_.size();
+            }
+
+            return entries_[slot.ent - 1].second;
+        }
+
+        /// make room for cnt entries in total without rehashing
+        void reserve(const size_t cnt)
+        {
+            // entries are numbered by uint32_t, the size cannot overflow then
+            if (UINT32_MAX <= cnt)
+                throw std::length_error("FlatHashMap::reserve()");
+
+            size_t size = 16U;
+            while (size / 2U <= cnt)
+                size *= 2U;
+
+            if (slots_.size() < size)
+                this->rehash(size);
+
+            entries_.reserve(cnt);
+        }
+
+        /// call fnc(key, val, hash) for each entry
+        template <class TFnc>
+        void forEach(TFnc fnc) const
+        {
+            for (const TSlot &slot : slots_) {
+                if (!slot.ent)
+                    continue;
+
+                const auto &ent = entries_[slot.ent - 1];
+                fnc(ent.first, ent.second, slot.hash);
+            }
+        }
+
+    private:
+        struct TSlot {
+            uint64_t                hash = 0U;
+            uint32_t                ent  = 0U;  ///< index to entries_ + 1
+        };
+
+        std::vector<TSlot>                          slots_;
+        std::vector<std::pair<TKey, TVal>>          entries_;
+
+        /// return index of the slot holding key, or of the first free slot
+        size_t findSlot(const TKey &key, const uint64_t hash) const
+        {
+            const size_t mask = slots_.size() - 1U;
+            for (size_t idx = hash & mask;; idx = (idx + 1U) & mask) {
+                const TSlot &slot = slots_[idx];
+                if (!slot.ent)
+                    return idx;
+
+                // verify the key in case of a hash collision
+                if (slot.hash == hash && entries_[slot.ent - 1].first == key)
+                    return idx;
+            }
+        }
+
+        void rehash(const size_t size)
+        {
+            std::vector<TSlot> slots(size);
+            const size_t mask = size - 1U;
+            for (const TSlot &slot : slots_) {
+                if (!slot.ent)
+                    continue;
+
+                size_t idx = slot.hash & mask;
+                while (slots[idx].ent)
+                    idx = (idx + 1U) & mask;
+
+                slots[idx] = slot;
+            }
+
+            slots_.swap(slots);
+        }
+};
+
+/// normalized key of a defect together with its precomputed hashes
+struct HashedKey {
+    DefKey                          key;
+    uint64_t                        pathHash;   ///< hash of key.pk
+    uint64_t                        hash;       ///< hash of the whole key
+};
+
+/// hash tables of DefLookup, shared by its copies until they are modified
+struct DefTables {
+    /// number of baseline defects not yet matched, per normalized key
+    FlatHashMap<DefKey, unsigned>           defCnt;
+
+    /// true if there is an "internal warning" for the given checker/path
+    FlatHashMap<PathKey, bool>              intWarn;
+};
 
 struct DefLookup::Private {
-    TDefByChecker                    stor;
-    bool                             usePartialResults;
+    std::shared_ptr<DefTables>              tab = std::make_shared<DefTables>();
+
+    /// number of matched defects per entry of tab->defCnt, used instead of
+    /// decrementing the counts while tab is shared with other copies
+    std::unordered_map<uint32_t, unsigned>  used;
+
+    bool                                    usePartialResults;
+
+    /// return the tables for writing, copy them first if they are shared
+    DefTables& tabToWrite() {
+        if (1 < tab.use_count())
+            tab = std::make_shared<DefTables>(*tab);
+
+        return *tab;
+    }
+
+    /// return the number of defects not yet matched for the given entry
+    unsigned cntAt(uint32_t ent) const;
+
+    void initKey(HashedKey *pHk, const Defect &def) const;
+    void initMsg(HashedKey *pHk, const Defect &def) const;
+    void addKey(const HashedKey &hk);
+    bool matchPath(bool *pResult, const HashedKey &hk);
+    bool matchKey(const HashedKey &hk);
 };
 
+/// initialize the normalized key of def except msg and the hash of checker/path
+void DefLookup::Private::initKey(HashedKey *pHk, const Defect &def) const
+{
+    const MsgFilter &filter = MsgFilter::inst();
+    const DefEvent &evt = def.events[def.keyEventIdx];
+
+    DefKey &key = pHk->key;
+    key.pk.checker = def.checker;
+    key.pk.path = filter.filterPath(evt.fileName);
+    key.event = evt.event;
+
+    uint64_t hash = hashChain(hashInit, key.pk.checker);
+    pHk->pathHash = hashChain(hash, key.pk.path);
+}
+
+/// complete the key initialized by initKey() by the filtered msg
+void DefLookup::Private::initMsg(HashedKey *pHk, const Defect &def) const
+{
+    const MsgFilter &filter = MsgFilter::inst();
+    DefKey &key = pHk->key;
+    key.msg = filter.filterMsg(def.events[def.keyEventIdx].msg, def.checker);
+    pHk->hash = hashChain(hashChain(pHk->pathHash, key.event), key.msg);
+}
+
+unsigned DefLookup::Private::cntAt(const uint32_t ent) const
+{
+    const unsigned cnt = this->tab->defCnt.valueAt(ent);
+    if (this->used.empty())
+        return cnt;
+
+    const auto it = this->used.find(ent);
+    return (this->used.end() == it)
+        ? cnt
+        : cnt - it->second;
+}
+
+void DefLookup::Private::addKey(const HashedKey &hk)
+{
+    DefTables &tw = this->tabToWrite();
+
+    // the checker/path entry is created even if there is no internal warning
+    bool &intWarn = tw.intWarn.lookupOrInsert(hk.key.pk, hk.pathHash);
+    if (hk.key.event == "internal warning")
+        intWarn = true;
+
+    ++tw.defCnt.lookupOrInsert(hk.key, hk.hash);
+}
+
+/// look for checker/path, return true if it decides the result of the lookup
+bool DefLookup::Private::matchPath(bool *pResult, const HashedKey &hk)
+{
+    const bool *pIntWarn = this->tab->intWarn.find(hk.key.pk, hk.pathHash);
+    if (!pIntWarn) {
+        *pResult = false;
+        return true;
+    }
+
+    if (!this->usePartialResults && *pIntWarn) {
+        // if the analyzer produced an "internal warning" diagnostic message,
+        // we assume partial results, which cannot be reliably used for
+        // differential scan ==> pretend we found what we had been looking
+        // for, but do not remove anything from the store
+        *pResult = true;
+        return true;
+    }
+
+    // msg needs to be compared
+    return false;
+}
+
+/// look by key event and msg, consume the matched entry
+bool DefLookup::Private::matchKey(const HashedKey &hk)
+{
+    const uint32_t ent = this->tab->defCnt.findEntry(hk.key, hk.hash);
+    if (!ent || !this->cntAt(ent))
+        return false;
+
+    // FIXME: nasty over-approximation
+    // just remove an arbitrary one
+    if (1 == this->tab.use_count())
+        --this->tab->defCnt.valueAt(ent);
+    else
+        ++this->used[ent];
+
+    // TODO: add some other criteria in order to make the match more precise
+    return true;
+}
+
 DefLookup::DefLookup(const bool usePartialResults):
     d(new Private)
 {
@@ -63,64 +367,488 @@ DefLookup::~DefLookup()
 
 void DefLookup::hashDefect(const Defect &def)
 {
-    TDefByFile &row = d->stor[def.checker];
+    HashedKey hk;
+    d->initKey(&hk, def);
+    d->initMsg(&hk, def);
+    d->addKey(hk);
+}
 
-    const DefEvent &evt = def.events[def.keyEventIdx];
-    const MsgFilter &filter = MsgFilter::inst();
-    TDefByEvt &col = row[filter.filterPath(evt.fileName)];
-    TDefByMsg &zCol = col[evt.event];
-    TDefList &cell = zCol[filter.filterMsg(evt.msg, def.checker)];
+bool DefLookup::lookup(const Defect &def)
+{
+    HashedKey hk;
+    d->initKey(&hk, def);
 
-    cell.push_back(def);
+    bool result;
+    if (d->matchPath(&result, hk))
+        return result;
+
+    // msg is filtered only if needed
+    d->initMsg(&hk, def);
+    return d->matchKey(hk);
 }
 
-bool DefLookup::lookup(const Defect &def)
+void DefLookup::watchDefect(const Defect &def)
+{
+    HashedKey hk;
+    d->initKey(&hk, def);
+    d->initMsg(&hk, def);
+
+    // create the entries without counting the defect
+    DefTables &tw = d->tabToWrite();
+    tw.intWarn.lookupOrInsert(hk.key.pk, hk.pathHash);
+    tw.defCnt.lookupOrInsert(hk.key, hk.hash);
+}
+
+void DefLookup::hashWatchedDefect(const Defect &def)
+{
+    HashedKey hk;
+    d->initKey(&hk, def);
+
+    // the msg is not filtered for defects with no watched checker/path
+    DefTables &tw = d->tabToWrite();
+    bool *pIntWarn = tw.intWarn.find(hk.key.pk, hk.pathHash);
+    if (!pIntWarn)
+        return;
+
+    if (hk.key.event == "internal warning")
+        *pIntWarn = true;
+
+    d->initMsg(&hk, def);
+    unsigned *pCnt = tw.defCnt.find(hk.key, hk.hash);
+    if (pCnt)
+        ++(*pCnt);
+}
+
+void DefLookup::diffBoth(
+        std::vector<bool>          *pAdded,
+        std::vector<bool>          *pFixed,
+        const TDefList             &oldDefs,
+        const TDefList             &newDefs,
+        const bool                  usePartialResults)
+{
+    Private oldStor, newStor;
+    oldStor.usePartialResults = usePartialResults;
+    newStor.usePartialResults = usePartialResults;
+
+    // normalize each defect only once and hash it into the index of its scan
+    const auto hashAll = [](std::vector<HashedKey> *pKeys, Private *pStor,
+            const TDefList &defs)
+    {
+        pKeys->resize(defs.size());
+        for (size_t i = 0U; i < defs.size(); ++i) {
+            HashedKey &hk = (*pKeys)[i];
+            pStor->initKey(&hk, defs[i]);
+            pStor->initMsg(&hk, defs[i]);
+            pStor->addKey(hk);
+        }
+    };
+
+    std::vector<HashedKey> oldKeys, newKeys;
+    hashAll(&oldKeys, &oldStor, oldDefs);
+    hashAll(&newKeys, &newStor, newDefs);
+
+    // look up the keys of each scan in the index of the other one
+    const auto matchAll = [](std::vector<bool> *pUnmatched, Private *pStor,
+            const std::vector<HashedKey> &keys)
+    {
+        pUnmatched->resize(keys.size());
+        for (size_t i = 0U; i < keys.size(); ++i) {
+            bool result;
+            if (!pStor->matchPath(&result, keys[i]))
+                result = pStor->matchKey(keys[i]);
+
+            (*pUnmatched)[i] = !result;
+        }
+    };
+
+    matchAll(pAdded, &oldStor, newKeys);
+    matchAll(pFixed, &newStor, oldKeys);
+}
+
+// Layout of the index file written by DefLookup::writeIndex().  All integers
+// are 64-bit words in the byte order of the host that wrote the index:
+//
+//  - header: magic bytes, format version, byte order mark, fingerprint of the
+//    MsgFilter rules (two words), number of scan properties, checker/path
+//    entries, and defect entries, number of strings, size of the string data
+//  - string table: end offsets of the strings followed by their data padded
+//    to a whole number of words
+//  - scan properties: indexes of the key and the value
+//  - checker/path entries: hash, checker, path, internal warning flag
+//  - defect entries: hash, checker, path, event, msg, count
+//
+// Strings are referred by their indexes to the string table.  The hashes are
+// stored so that the hash tables are rebuilt without reading the strings.
+
+/// the first byte is not valid in text, the same as in binary-format.hh
+static const char indexMagic[] = "\x89" "CSIDX\x1a\n";
+static const size_t indexMagicSize = sizeof(indexMagic) - 1U;
+
+static const uint64_t indexVersion = 1U;
+static const uint64_t indexByteOrder = 0x0102030405060708ULL;
+
+static const size_t wordSize = sizeof(uint64_t);
+static const size_t pathEntryWords = 4U;
+static const size_t defEntryWords = 6U;
+
+/// words of the index file written after the magic bytes and the string table
+class IndexWriter {
+    public:
+        void addWord(const uint64_t word) {
+            words_.push_back(word);
+        }
+
+        void addStr(const std::string &str) {
+            const auto res = strMap_.emplace(str, strList_.size());
+            if (res.second)
+                strList_.push_back(&res.first->first);
+
+            words_.push_back(res.first->second);
+        }
+
+        void write(
+                std::ostream               &str,
+                const uint64_t             *head,
+                size_t                      headSize);
+
+    private:
+        std::unordered_map<std::string, uint64_t>   strMap_;
+        std::vector<const std::string *>            strList_;
+        std::vector<uint64_t>                       words_;
+
+        void writeWord(std::ostream &str, const uint64_t word) {
+            str.write(reinterpret_cast<const char *>(&word), wordSize);
+        }
+};
+
+/// write the header followed by the string table and the words added so far,
+/// the header is completed by the number of strings and the size of their data
+void IndexWriter::write(
+        std::ostream               &str,
+        const uint64_t             *head,
+        const size_t                headSize)
 {
-    // look for defect class
-    TDefByChecker::iterator iRow = d->stor.find(def.checker);
-    if (d->stor.end() == iRow)
+    str.write(indexMagic, indexMagicSize);
+    for (size_t i = 0U; i < headSize; ++i)
+        this->writeWord(str, head[i]);
+
+    uint64_t strBytes = 0U;
+    for (const std::string *pStr : strList_)
+        strBytes += pStr->size();
+
+    this->writeWord(str, strList_.size());
+    this->writeWord(str, strBytes);
+
+    uint64_t end = 0U;
+    for (const std::string *pStr : strList_)
+        this->writeWord(str, end += pStr->size());
+
+    for (const std::string *pStr : strList_)
+        str.write(pStr->data(), pStr->size());
+
+    // pad the string data to a whole number of words
+    const char zeros[wordSize] = {};
+    str.write(zeros, (wordSize - strBytes % wordSize) % wordSize);
+
+    for (const uint64_t word : words_)
+        this->writeWord(str, word);
+}
+
+bool DefLookup::writeIndex(std::ostream &str, const TScanProps &scanProps)
+    const
+{
+    IndexWriter iw;
+    for (TScanProps::const_reference item : scanProps) {
+        iw.addStr(item.first);
+        iw.addStr(item.second);
+    }
+
+    size_t pathCnt = 0U;
+    d->tab->intWarn.forEach([&](const PathKey &pk, bool intWarn, uint64_t hash)
+    {
+        iw.addWord(hash);
+        iw.addStr(pk.checker);
+        iw.addStr(pk.path);
+        iw.addWord(intWarn);
+        ++pathCnt;
+    });
+
+    size_t defCnt = 0U;
+    const DefTables &tab = *d->tab;
+    tab.defCnt.forEach([&](const DefKey &key, unsigned, uint64_t hash) {
+        iw.addWord(hash);
+        iw.addStr(key.pk.checker);
+        iw.addStr(key.pk.path);
+        iw.addStr(key.event);
+        iw.addStr(key.msg);
+
+        // count only the defects that have not been matched yet
+        iw.addWord(d->cntAt(tab.defCnt.findEntry(key, hash)));
+        ++defCnt;
+    });
+
+    const Fingerprint fp = MsgFilter::inst().rulesFingerprint();
+    const uint64_t head[] = {
+        indexVersion,
+        indexByteOrder,
+        fp.hi,
+        fp.lo,
+        scanProps.size(),
+        pathCnt,
+        defCnt
+    };
+
+    iw.write(str, head, sizeof(head) / sizeof(head[0]));
+    str.flush();
+    return !str.fail();
+}
+
+bool DefLookup::isIndex(InStream &input)
+{
+    InStreamLookAhead head(input, indexMagicSize);
+    for (size_t i = 0U; i < indexMagicSize; ++i)
+        if (indexMagic[i] != head[i])
+            return false;
+
+    return true;
+}
+
+/// sequential reader of the words and strings of an index file in memory
+class IndexReader {
+    public:
+        explicit IndexReader(const boost::string_view data):
+            data_(data)
+        {
+        }
+
+        bool readWord(uint64_t *pDst);
+        bool readStrTab(size_t strCnt, size_t strBytes);
+
+        /// read a string index and return the string as a symbol
+        bool readSym(Symbol *pDst);
+
+        /// read a string index and return a copy of the string
+        bool readStr(std::string *pDst);
+
+        /// return true if the remaining data hold at least cnt words
+        bool hasWords(const uint64_t cnt) const {
+            return cnt <= (data_.size() - pos_) / wordSize;
+        }
+
+        /// return true if the remaining data hold the given numbers of
+        /// entries, each entry taking the given number of words
+        bool hasEntries(
+                const std::initializer_list<std::pair<uint64_t, size_t>> ents)
+            const;
+
+    private:
+        const boost::string_view            data_;
+        size_t                              pos_ = 0U;
+        std::vector<boost::string_view>     strTab_;
+
+        /// symbols interned on demand for the entries of strTab_
+        std::vector<Symbol>                 symTab_;
+        std::vector<bool>                   hasSym_;
+
+        bool readStrIdx(size_t *pIdx);
+};
+
+bool IndexReader::readWord(uint64_t *pDst)
+{
+    if (!this->hasWords(1U))
         return false;
 
-    // simplify path
-    const MsgFilter &filter = MsgFilter::inst();
-    const DefEvent &evt = def.events[def.keyEventIdx];
-    const std::string path(filter.filterPath(evt.fileName));
+    memcpy(pDst, data_.data() + pos_, wordSize);
+    pos_ += wordSize;
+    return true;
+}
+
+bool IndexReader::hasEntries(
+        const std::initializer_list<std::pair<uint64_t, size_t>> ents)
+    const
+{
+    // check each count on its own so that no product or sum can overflow
+    uint64_t remain = (data_.size() - pos_) / wordSize;
+    for (const auto &ent : ents) {
+        const uint64_t cnt = ent.first;
+        const size_t entryWords = ent.second;
+        if (remain / entryWords < cnt)
+            return false;
+
+        remain -= cnt * entryWords;
+    }
+
+    return true;
+}
 
-    // look for file name
-    TDefByFile &row = iRow->second;
-    TDefByFile::iterator iCol = row.find(path);
-    if (row.end() == iCol)
+bool IndexReader::readStrTab(const size_t strCnt, const size_t strBytes)
+{
+    const size_t padded = strBytes / wordSize + !!(strBytes % wordSize);
+    if (!this->hasWords(strCnt) || !this->hasWords(padded)
+            || !this->hasWords(strCnt + padded))
         return false;
 
-    TDefByEvt &col = iCol->second;
-    if (!d->usePartialResults && col.end() != col.find("internal warning"))
-        // if the analyzer produced an "internal warning" diagnostic message,
-        // we assume partial results, which cannot be reliably used for
-        // differential scan ==> pretend we found what we had been looking
-        // for, but do not remove anything from the store
-        return true;
+    const char *strData = data_.data() + pos_ + strCnt * wordSize;
+    strTab_.reserve(strCnt);
+    uint64_t beg = 0U;
+    for (size_t i = 0U; i < strCnt; ++i) {
+        uint64_t end;
+        this->readWord(&end);
+        if (end < beg || strBytes < end)
+            return false;
+
+        strTab_.emplace_back(strData + beg, end - beg);
+        beg = end;
+    }
 
-    // look by key event
-    TDefByEvt::iterator iZCol = col.find(evt.event);
-    if (col.end() == iZCol)
+    symTab_.resize(strCnt);
+    hasSym_.resize(strCnt, false);
+    pos_ += padded * wordSize;
+    return true;
+}
+
+bool IndexReader::readStrIdx(size_t *pIdx)
+{
+    uint64_t idx;
+    if (!this->readWord(&idx) || strTab_.size() <= idx)
         return false;
 
-    // look by msg
-    TDefByMsg &zCol = iZCol->second;
-    TDefByMsg::iterator iCell = zCol.find(
-            filter.filterMsg(evt.msg, def.checker));
-    if (zCol.end() == iCell)
+    *pIdx = idx;
+    return true;
+}
+
+bool IndexReader::readSym(Symbol *pDst)
+{
+    size_t idx;
+    if (!this->readStrIdx(&idx))
         return false;
 
-    // FIXME: nasty over-approximation
-    TDefList &defs = iCell->second;
-    unsigned cnt = defs.size();
-    if (cnt)
-        // just remove an arbitrary one
-        defs.resize(cnt - 1);
-    else
+    if (!hasSym_[idx]) {
+        symTab_[idx] = Symbol(strTab_[idx]);
+        hasSym_[idx] = true;
+    }
+
+    *pDst = symTab_[idx];
+    return true;
+}
+
+bool IndexReader::readStr(std::string *pDst)
+{
+    size_t idx;
+    if (!this->readStrIdx(&idx))
         return false;
 
-    // TODO: add some other criteria in order to make the match more precise
+    const boost::string_view str = strTab_[idx];
+    pDst->assign(str.data(), str.size());
     return true;
 }
+
+bool DefLookup::readIndex(InStream &input, TScanProps *pScanProps)
+{
+    // use the mapped file if available, read the whole input otherwise
+    std::string buf;
+    boost::string_view data;
+    if (!input.mappedData(&data)) {
+        std::istream &str = input.str();
+        buf.assign(std::istreambuf_iterator<char>(str),
+                std::istreambuf_iterator<char>());
+        data = buf;
+    }
+
+    if (data.size() < indexMagicSize
+            || data.substr(0U, indexMagicSize) != indexMagic)
+    {
+        input.handleError("not an index file");
+        return false;
+    }
+
+    IndexReader rd(data.substr(indexMagicSize));
+    uint64_t head[9];
+    for (uint64_t &word : head) {
+        if (!rd.readWord(&word)) {
+            input.handleError("truncated index file");
+            return false;
+        }
+    }
+
+    if (indexVersion != head[0] || indexByteOrder != head[1]) {
+        input.handleError("unsupported version or byte order of index file");
+        return false;
+    }
+
+    const Fingerprint fp = MsgFilter::inst().rulesFingerprint();
+    if (fp.hi != head[2] || fp.lo != head[3]) {
+        input.handleError("index file built with different filtering rules, "
+                "it needs to be rebuilt");
+        return false;
+    }
+
+    const uint64_t propCnt = head[4];
+    const uint64_t pathCnt = head[5];
+    const uint64_t defCnt  = head[6];
+    const uint64_t strCnt  = head[7];
+    const uint64_t strBytes = head[8];
+
+    // check the counts before any memory is allocated for them
+    if (!rd.readStrTab(strCnt, strBytes)
+            || !rd.hasEntries({
+                { propCnt, 2U },
+                { pathCnt, pathEntryWords },
+                { defCnt,  defEntryWords } }))
+    {
+        input.handleError("truncated index file");
+        return false;
+    }
+
+    TScanProps scanProps;
+    for (uint64_t i = 0U; i < propCnt; ++i) {
+        std::string key, val;
+        if (!rd.readStr(&key) || !rd.readStr(&val))
+            goto fail;
+
+        scanProps[key] = std::move(val);
+    }
+
+    {
+        Private tmp;
+        tmp.usePartialResults = d->usePartialResults;
+
+        DefTables &tw = *tmp.tab;
+        tw.intWarn.reserve(pathCnt);
+        for (uint64_t i = 0U; i < pathCnt; ++i) {
+            uint64_t hash, intWarn;
+            PathKey pk;
+            if (!rd.readWord(&hash)
+                    || !rd.readSym(&pk.checker)
+                    || !rd.readSym(&pk.path)
+                    || !rd.readWord(&intWarn))
+                goto fail;
+
+            tw.intWarn.lookupOrInsert(pk, hash) = intWarn;
+        }
+
+        tw.defCnt.reserve(defCnt);
+        for (uint64_t i = 0U; i < defCnt; ++i) {
+            uint64_t hash, cnt;
+            DefKey key;
+            if (!rd.readWord(&hash)
+                    || !rd.readSym(&key.pk.checker)
+                    || !rd.readSym(&key.pk.path)
+                    || !rd.readSym(&key.event)
+                    || !rd.readStr(&key.msg)
+                    || !rd.readWord(&cnt))
+                goto fail;
+
+            tw.defCnt.lookupOrInsert(key, hash) = cnt;
+        }
+
+        *d = std::move(tmp);
+    }
+
+    *pScanProps = std::move(scanProps);
+    return true;
+
+fail:
+    input.handleError("invalid string index in index file");
+    return false;
+}
@@ -20,19 +20,58 @@
 #ifndef H_GUARD_DEFLOOKUP_H
 #define H_GUARD_DEFLOOKUP_H
 
-struct Defect;
+#include "parser.hh"
+
+#include <iostream>
+#include <vector>
 
 class DefLookup {
     public:
         DefLookup(bool usePartialResults = false);
         ~DefLookup();
 
+        /// copies are cheap, they share the hash tables and only remember
+        /// their own matches until new defects are hashed into them
         DefLookup(const DefLookup &);
         DefLookup& operator=(const DefLookup &);
 
         void hashDefect(const Defect &);
         bool lookup(const Defect &);
 
+        /// make hashWatchedDefect() count defects with the same key as def,
+        /// def itself is not counted
+        void watchDefect(const Defect &def);
+
+        /// the same as hashDefect() but only for the keys that have been passed
+        /// to watchDefect(), other defects are dropped.  Subsequent lookups of
+        /// the watched defects give the same results as if all the defects were
+        /// hashed by hashDefect() while memory depends only on the watched keys.
+        void hashWatchedDefect(const Defect &def);
+
+        using TDefList = std::vector<Defect>;
+
+        /// match two scans against each other, normalizing each defect only
+        /// once.  Set (*pAdded)[i] if newDefs[i] has no match in oldDefs and
+        /// (*pFixed)[i] if oldDefs[i] has no match in newDefs.  The result is
+        /// the same as if lookup() was called in both directions.
+        static void diffBoth(
+                std::vector<bool>          *pAdded,
+                std::vector<bool>          *pFixed,
+                const TDefList             &oldDefs,
+                const TDefList             &newDefs,
+                bool                        usePartialResults);
+
+        /// write the normalized keys of the hashed defects and their counts
+        /// to an index file that can be loaded by readIndex() later on
+        bool writeIndex(std::ostream &, const TScanProps &scanProps) const;
+
+        /// return true if the input looks like an index file
+        static bool isIndex(InStream &);
+
+        /// replace the hashed defects by the contents of an index file, fail
+        /// if the index was built with different rules of MsgFilter
+        bool readIndex(InStream &, TScanProps *pScanProps);
+
     private:
         struct Private;
         Private *d;
@@ -19,12 +19,15 @@
 
 #include "filter.hh"
 
+#include "fingerprint.hh"
 #include "msg-filter.hh"
+#include "src-cache.hh"
 
-#include <fstream>
+#include <algorithm>
 #include <iomanip>
+#include <iostream>
 #include <queue>
-#include <set>
+#include <unordered_set>
 #include <sstream>
 
 #include <boost/algorithm/string/replace.hpp>
@@ -32,22 +35,26 @@
 // /////////////////////////////////////////////////////////////////////////////
 // implementation of EventPrunner
 
-void EventPrunner::handleDef(const Defect &defOrig)
+void EventPrunner::transformDef(Defect *pDef)
 {
-    Defect def(defOrig);
-    def.events.clear();
+    TEvtList &evtList = pDef->events;
+    const unsigned keyEventIdx = pDef->keyEventIdx;
 
-    const unsigned cnt = defOrig.events.size();
+    // move the events we keep to the front of the list
+    unsigned dst = 0U;
+    const unsigned cnt = evtList.size();
     for (unsigned i = 0; i < cnt; ++i) {
-        const DefEvent &evt = defOrig.events[i];
-
-        if (evt.verbosityLevel <= thr_)
-            def.events.push_back(evt);
-        else if (i < defOrig.keyEventIdx)
-            def.keyEventIdx--;
+        if (evtList[i].verbosityLevel <= thr_) {
+            if (dst != i)
+                std::swap(evtList[dst], evtList[i]);
+            ++dst;
+        }
+        else if (i < keyEventIdx)
+            pDef->keyEventIdx--;
     }
 
-    agent_->handleDef(def);
+    // return the pruned events to the pool
+    defPool_.resizeEvents(&evtList, dst);
 }
 
 
@@ -70,27 +77,22 @@ void dropCtxLines(TEvtList *pEvtList)
 }
 
 void appendCtxLines(
-        TEvtList       *pDst,
-        std::istream   &inStr,
-        const int       defLine,
-        const int       ctxLines)
+        TEvtList                   *pDst,
+        const std::string          &fileName,
+        const int                   defLine,
+        const int                   ctxLines)
 {
     if (ctxLines < 0)
         return;
 
-    const int firstLine = defLine - ctxLines;
-    const int lastLine  = defLine + ctxLines;
+    SrcFileCache &cache = SrcFileCache::inst();
+    const int firstLine = std::max(1, defLine - ctxLines);
+    const int lastLine  = std::min(cache.lineCount(fileName), defLine + ctxLines);
 
-    int line = 1;
-    std::string text;
-    for (; line <= lastLine; ++line) {
-        if (!std::getline(inStr, text))
-            // premature end of input
-            break;
-
-        if (line < firstLine)
-            // skip lines before the context lines
-            continue;
+    boost::string_view view;
+    for (int line = firstLine; line <= lastLine; ++line) {
+        cache.getLine(&view, fileName, line);
+        std::string text(view.data(), view.size());
 
         // quote embedded NULs as they cause problems to some JSON parsers
         std::string nul;
@@ -115,30 +117,22 @@ void appendCtxLines(
     }
 }
 
-void CtxEmbedder::handleDef(const Defect &defOrig)
+void CtxEmbedder::transformDef(Defect *pDef)
 {
-    const DefEvent &evt = defOrig.events[defOrig.keyEventIdx];
-    if (!evt.line) {
+    const DefEvent &evt = pDef->events[pDef->keyEventIdx];
+    const int line = evt.line;
+    if (!line)
         // no line number for the key event
-        agent_->handleDef(defOrig);
         return;
-    }
 
-    std::ifstream fstr(evt.fileName);
-    if (!fstr) {
+    const Symbol fileName = evt.fileName;
+    if (SrcFileCache::inst().lineCount(fileName) < 0)
         // failed to open input file
-        agent_->handleDef(defOrig);
         return;
-    }
-
-    // clone defOrig and append the context lines
-    Defect def(defOrig);
-    dropCtxLines(&def.events);
-    appendCtxLines(&def.events, fstr, evt.line, ctxLines_ - 1);
 
-    // close the file stream and forward the result
-    fstr.close();
-    agent_->handleDef(def);
+    // append the context lines (evt is not valid after this point)
+    dropCtxLines(&pDef->events);
+    appendCtxLines(&pDef->events, fileName, line, ctxLines_ - 1);
 }
 
 
@@ -183,26 +177,86 @@ void ScanPropSetter::setScanProps(const TScanProps &origProps)
 // /////////////////////////////////////////////////////////////////////////////
 // implementation of DuplicateFilter
 
+/// hash of all fields of DefEvent, interned strings are hashed by identity
+struct DefEventHash {
+    size_t operator()(const DefEvent &evt) const {
+        size_t hash = evt.fileName.hash();
+        hashCombine(&hash, evt.line);
+        hashCombine(&hash, evt.column);
+        hashCombine(&hash, evt.event.hash());
+        hashCombine(&hash, std::hash<std::string>()(evt.msg));
+        hashCombine(&hash, evt.verbosityLevel);
+        return hash;
+    }
+
+    static void hashCombine(size_t *pHash, const size_t val) {
+        *pHash ^= val + 0x9e3779b97f4a7c15ULL + (*pHash << 6) + (*pHash >> 2);
+    }
+};
+
+struct DefEventEq {
+    bool operator()(const DefEvent &a, const DefEvent &b) const {
+        return a.fileName == b.fileName
+            && a.line == b.line
+            && a.column == b.column
+            && a.event == b.event
+            && a.msg == b.msg
+            && a.verbosityLevel == b.verbosityLevel;
+    }
+};
+
 struct DuplicateFilter::Private {
-    using TLookup = std::set<DefEvent>;
-    TLookup lookup;
+    // fingerprints of the normalized key events seen so far
+    FingerprintSet lookup;
+
+    // exact keys, only maintained if verification of fingerprints is enabled
+    using TExactLookup = std::unordered_set<DefEvent, DefEventHash, DefEventEq>;
+    TExactLookup exactLookup;
+    bool verify = false;
+    bool collisionReported = false;
 };
 
-DuplicateFilter::DuplicateFilter(AbstractWriter *agent):
+DuplicateFilter::DuplicateFilter(AbstractWriter *agent, bool verify):
     AbstractFilter(agent),
     d(new Private)
 {
+    d->verify = verify;
 }
 
 bool DuplicateFilter::matchDef(const Defect &def)
 {
-    DefEvent evt = def.events[def.keyEventIdx];
+    const DefEvent &keyEvt = def.events[def.keyEventIdx];
 
     // abstract out differences we do not deem important
-    evt.fileName = MsgFilter::inst().filterPath(evt.fileName);
-    evt.msg = MsgFilter::inst().filterMsg(evt.msg, def.checker);
+    const MsgFilter &filter = MsgFilter::inst();
+    std::string path = filter.filterPath(keyEvt.fileName);
+    std::string msg = filter.filterMsg(keyEvt.msg, def.checker);
+
+    const Fingerprint fp = FingerprintBuilder()
+        .add(path)
+        .add(keyEvt.line)
+        .add(keyEvt.column)
+        .add(keyEvt.event.str())
+        .add(msg)
+        .add(keyEvt.verbosityLevel)
+        .result();
+
+    const bool inserted = d->lookup.insert(fp);
+    if (!d->verify)
+        return inserted;
+
+    // check the result against the exact key
+    DefEvent evt = keyEvt;
+    evt.fileName = path;
+    evt.msg = std::move(msg);
+    const bool insertedExact = d->exactLookup.insert(std::move(evt)).second;
+    if (inserted != insertedExact && !d->collisionReported) {
+        std::cerr << "warning: fingerprint collision detected while removing "
+            "duplicates: " << path << ":" << keyEvt.line << "\n";
+        d->collisionReported = true;
+    }
 
-    return d->lookup.insert(evt)./* inserted */second;
+    return insertedExact;
 }
 
 
@@ -211,10 +265,15 @@ bool DuplicateFilter::matchDef(const Defect &def)
 
 struct RateLimitter::Private {
     // counter of checker/key-event pairs
-    using TKey = std::pair<std::string, std::string>;
     using TCnt = int;
-    using TMap = std::map<TKey, TCnt>;
-    TMap counter;
+    FingerprintMap<TCnt> counter;
+
+    // exact counters, only maintained if verification of fingerprints is enabled
+    using TKey = std::pair<std::string, std::string>;
+    using TExactMap = std::map<TKey, TCnt>;
+    TExactMap exactCounter;
+    bool verify = false;
+    bool collisionReported = false;
 
     // list of defects where the limit was exceeded
     using TErrorList = std::queue<Defect>;
@@ -222,23 +281,53 @@ struct RateLimitter::Private {
 
     // rate limit set during initialization
     TCnt rateLimit;
+
+    TCnt add(const std::string &checker, const std::string &event, TCnt);
 };
 
-RateLimitter::RateLimitter(AbstractWriter *agent, int rateLimit):
+/// add delta to the counter of the checker/event pair and return its new value
+RateLimitter::Private::TCnt RateLimitter::Private::add(
+        const std::string          &checker,
+        const std::string          &event,
+        const TCnt                  delta)
+{
+    const Fingerprint fp = FingerprintBuilder()
+        .add(checker)
+        .add(event)
+        .result();
+
+    bool inserted;
+    const TCnt cnt = (this->counter.lookupOrInsert(fp, &inserted) += delta);
+    if (!this->verify)
+        return cnt;
+
+    // check the result against the exact key
+    const TKey key(checker, event);
+    const TCnt cntExact = (this->exactCounter[key] += delta);
+    if (cnt != cntExact && !this->collisionReported) {
+        std::cerr << "warning: fingerprint collision detected while limiting "
+            "the rate of warnings: " << checker << ": " << event << "\n";
+        this->collisionReported = true;
+    }
+
+    return cntExact;
+}
+
+RateLimitter::RateLimitter(AbstractWriter *agent, int rateLimit, bool verify):
     AbstractFilter(agent),
     d(new Private)
 {
     d->rateLimit = rateLimit;
+    d->verify = verify;
 }
 
 bool RateLimitter::matchDef(const Defect &def)
 {
     // resolve the checker/event pair for the key event
-    DefEvent evt = def.events[def.keyEventIdx];
-    const Private::TKey key(def.checker, evt.event);
+    const DefEvent &keyEvt = def.events[def.keyEventIdx];
 
     // increment the counter and get the current value
-    const Private::TCnt cnt = ++d->counter[key];
+    const Private::TCnt cnt = d->add(def.checker, keyEvt.event, 1);
 
     // check whether the specified limit is exceeded
     if (cnt < d->rateLimit)
@@ -246,11 +335,13 @@ bool RateLimitter::matchDef(const Defect &def)
 
     if (cnt == d->rateLimit) {
         // record defect prototype containing the key event only (without msg)
+        DefEvent evt = keyEvt;
         evt.msg.clear();
 
         Defect defProto = def;
         defProto.events.clear();
         defProto.events.push_back(std::move(evt));
+        defProto.keyEventIdx = 0U;
         d->errors.push(std::move(defProto));
     }
 
@@ -268,8 +359,7 @@ void RateLimitter::flush()
         DefEvent evtNote = evtErr;
 
         // resolve the count of occurrences for this checker/event pair
-        const Private::TKey key(def.checker, evtErr.event);
-        const Private::TCnt cnt = d->counter[key];
+        const Private::TCnt cnt = d->add(def.checker, evtErr.event, 0);
 
         // construct an error event in-place
         std::ostringstream err, note;
@@ -290,7 +380,7 @@ void RateLimitter::flush()
         def.events.push_back(std::move(evtNote));
 
         // process the newly constructed defect by the chain of writers
-        GenericAbstractFilter::handleDef(def);
+        GenericAbstractFilter::handleDef(std::move(def));
     }
 
     // forward the call through the chain of writers
@@ -23,62 +23,60 @@
 #include "abstract-filter.hh"
 
 /// decorator
-class EventPrunner: public GenericAbstractFilter {
+class EventPrunner: public AbstractTransformer {
     private:
         int thr_;
 
     public:
         EventPrunner(AbstractWriter *agent, int thr):
-            GenericAbstractFilter(agent),
+            AbstractTransformer(agent),
             thr_(thr)
         {
         }
 
-        void handleDef(const Defect &defOrig) override;
+    protected:
+        void transformDef(Defect *pDef) override;
 };
 
 /// decorator
-class CtxEmbedder: public GenericAbstractFilter {
+class CtxEmbedder: public AbstractTransformer {
     private:
         int ctxLines_;
 
     public:
         CtxEmbedder(AbstractWriter *agent, const int ctxLines):
-            GenericAbstractFilter(agent),
+            AbstractTransformer(agent),
             ctxLines_(ctxLines)
         {
         }
 
-        void handleDef(const Defect &defOrig) override;
+    protected:
+        void transformDef(Defect *pDef) override;
 };
 
-class PathStripper: public GenericAbstractFilter {
+class PathStripper: public AbstractTransformer {
     public:
         PathStripper(AbstractWriter *agent, const std::string &prefix):
-            GenericAbstractFilter(agent),
+            AbstractTransformer(agent),
             prefStr_(prefix),
             prefSize_(prefix.size())
         {
         }
 
-        void handleDef(const Defect &defOrig) override {
-            Defect def(defOrig);
-
+    protected:
+        void transformDef(Defect *pDef) override {
             // iterate through all events
-            for (DefEvent &evt : def.events) {
-                std::string &path = evt.fileName;
+            for (DefEvent &evt : pDef->events) {
+                const std::string &path = evt.fileName;
                 if (path.size() < prefSize_)
                     continue;
 
-                const std::string str(path, /* pos */ 0U, prefSize_);
-                if (str != prefStr_)
+                if (path.compare(/* pos */ 0U, prefSize_, prefStr_))
                     continue;
 
                 // strip path prefix in this event
-                path.erase(/* pos */ 0U, prefSize_);
+                evt.fileName = path.substr(prefSize_);
             }
-
-            agent_->handleDef(def);
         }
 
     private:
@@ -86,28 +84,25 @@ class PathStripper: public GenericAbstractFilter {
         const size_t                prefSize_;
 };
 
-class PathPrepender: public GenericAbstractFilter {
+class PathPrepender: public AbstractTransformer {
     public:
         PathPrepender(AbstractWriter *agent, const std::string &prefix):
-            GenericAbstractFilter(agent),
+            AbstractTransformer(agent),
             prefix_(prefix)
         {
         }
 
-        void handleDef(const Defect &defOrig) override {
-            Defect def(defOrig);
-
+    protected:
+        void transformDef(Defect *pDef) override {
             // iterate through all events
-            for (DefEvent &evt : def.events) {
-                std::string &path = evt.fileName;
+            for (DefEvent &evt : pDef->events) {
+                const std::string &path = evt.fileName;
                 if (path.empty() || path[0] == '/')
                     // not a relative path
                     continue;
 
-                path.insert(0U, prefix_);
+                evt.fileName = prefix_ + path;
             }
-
-            agent_->handleDef(def);
         }
 
     private:
@@ -129,6 +124,11 @@ class DropScanProps: public GenericAbstractFilter {
             return emp_;
         }
 
+        /// defects pass through unchanged
+        void handleDefs(Defect *defs, const size_t cnt) override {
+            agent_->handleDefs(defs, cnt);
+        }
+
     private:
         const TScanProps emp_;
 };
@@ -142,6 +142,11 @@ class ScanPropSetter: public GenericAbstractFilter {
         /// override specified scan properties
         void setScanProps(const TScanProps &origProps) override;
 
+        /// defects pass through unchanged
+        void handleDefs(Defect *defs, const size_t cnt) override {
+            agent_->handleDefs(defs, cnt);
+        }
+
     private:
         // key/val pairs are stored in a vector
         using TItem = std::pair<std::string, std::string>;
@@ -149,9 +154,13 @@ class ScanPropSetter: public GenericAbstractFilter {
         TList itemList_;
 };
 
+/// drops defects whose key event has already been seen
+///
+/// Only 128-bit fingerprints of the key events are kept in memory.  If verify
+/// is true, the exact key events are kept, too, and collisions are reported.
 class DuplicateFilter: public AbstractFilter {
     public:
-        DuplicateFilter(AbstractWriter *agent);
+        DuplicateFilter(AbstractWriter *agent, bool verify = false);
         ~DuplicateFilter() override = default;
 
     protected:
@@ -165,7 +174,9 @@ class DuplicateFilter: public AbstractFilter {
 /// collapses warnings if their count exceeds the specified limit
 class RateLimitter: public AbstractFilter {
     public:
-        RateLimitter(AbstractWriter *agent, int rateLimit);
+        /// counters are keyed by fingerprints of checker/event pairs, see
+        /// DuplicateFilter for the meaning of verify
+        RateLimitter(AbstractWriter *agent, int rateLimit, bool verify = false);
         ~RateLimitter() override = default;
         void flush() override;
 
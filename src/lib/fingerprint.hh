@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2023 Red Hat, Inc.
+ *
+ * This file is part of csdiff.
+ *
+ * csdiff is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * csdiff is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with csdiff.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef H_GUARD_FINGERPRINT_H
+#define H_GUARD_FINGERPRINT_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/// 128-bit fingerprint of a key, used instead of the key where a collision
+/// is unlikely enough to be ignored
+struct Fingerprint {
+    uint64_t                        hi = 0U;
+    uint64_t                        lo = 0U;
+};
+
+inline bool operator==(const Fingerprint &a, const Fingerprint &b)
+{
+    return a.hi == b.hi
+        && a.lo == b.lo;
+}
+
+inline bool operator!=(const Fingerprint &a, const Fingerprint &b)
+{
+    return !(a == b);
+}
+
+/// compute a Fingerprint of a sequence of strings and integers
+class FingerprintBuilder {
+    public:
+        FingerprintBuilder& add(const char *data, size_t size) {
+            // the size is mixed in first so that ("ab", "c") != ("a", "bc")
+            this->mix(size);
+
+            for (; 8U <= size; data += 8U, size -= 8U) {
+                uint64_t word;
+                memcpy(&word, data, 8U);
+                this->mix(word);
+            }
+
+            if (size) {
+                uint64_t word = 0U;
+                memcpy(&word, data, size);
+                this->mix(word);
+            }
+
+            return *this;
+        }
+
+        FingerprintBuilder& add(const std::string &str) {
+            return this->add(str.data(), str.size());
+        }
+
+        FingerprintBuilder& add(const int64_t num) {
+            this->mix(static_cast<uint64_t>(num));
+            return *this;
+        }
+
+        Fingerprint result() const {
+            // final mixing of both lanes as in MurmurHash3
+            uint64_t h1 = h1_;
+            uint64_t h2 = h2_;
+            h1 += h2;
+            h2 += h1;
+            h1 = fmix(h1);
+            h2 = fmix(h2);
+            h1 += h2;
+            h2 += h1;
+
+            Fingerprint fp;
+            fp.hi = h1;
+            fp.lo = h2;
+            return fp;
+        }
+
+    private:
+        uint64_t                    h1_ = 0x9e3779b97f4a7c15ULL;
+        uint64_t                    h2_ = 0xc2b2ae3d27d4eb4fULL;
+
+        static uint64_t rotl(const uint64_t x, const int r) {
+            return (x << r) | (x >> (64 - r));
+        }
+
+        static uint64_t fmix(uint64_t k) {
+            k ^= k >> 33;
+            k *= 0xff51afd7ed558ccdULL;
+            k ^= k >> 33;
+            k *= 0xc4ceb9fe1a85ec53ULL;
+            k ^= k >> 33;
+            return k;
+        }
+
+        /// mix a word into both lanes, each of them uses different constants
+        void mix(const uint64_t word) {
+            h1_ ^= rotl(word * 0x87c37b91114253d5ULL, 31) * 0x4cf5ad432745937fULL;
+            h1_ = rotl(h1_, 27) * 5U + 0x52dce729U;
+            h2_ ^= rotl(word * 0x4cf5ad432745937fULL, 33) * 0x87c37b91114253d5ULL;
+            h2_ = rotl(h2_, 31) * 5U + 0x38495ab5U;
+        }
+};
+
+/// open-addressing hash table of fingerprints with linear probing, each slot
+/// holds the fingerprint and the value associated with it
+template <class TVal>
+class FingerprintMap {
+    public:
+        /// return the value stored for fp, value-initialize it if missing
+        TVal& lookupOrInsert(const Fingerprint &fpOrig, bool *pInserted) {
+            // keep the load factor at or below 3/4
+            if (4U * (size_ + 1U) > 3U * slots_.size())
+                this->rehash(slots_.empty() ? 16U : 2U * slots_.size());
+
+            const Fingerprint fp = nonEmpty(fpOrig);
+            TSlot &slot = slots_[this->findSlot(fp)];
+            *pInserted = (slot.fp == Fingerprint());
+            if (*pInserted) {
+                slot.fp = fp;
+                ++size_;
+            }
+
+            return slot.val;
+        }
+
+        /// return the count of fingerprints stored in the table
+        size_t size() const {
+            return size_;
+        }
+
+    private:
+        struct TSlot {
+            Fingerprint             fp;     ///< all zeros for an empty slot
+            TVal                    val{};
+        };
+
+        std::vector<TSlot>          slots_;
+        size_t                      size_ = 0U;
+
+        /// the all-zeros fingerprint marks empty slots, so we remap it
+        static Fingerprint nonEmpty(Fingerprint fp) {
+            if (fp == Fingerprint())
+                fp.lo = 1U;
+
+            return fp;
+        }
+
+        /// return index of the slot holding fp, or of the first free slot
+        size_t findSlot(const Fingerprint &fp) const {
+            const size_t mask = slots_.size() - 1U;
+            for (size_t idx = fp.lo & mask;; idx = (idx + 1U) & mask) {
+                const Fingerprint &fpSlot = slots_[idx].fp;
+                if (fpSlot == fp || fpSlot == Fingerprint())
+                    return idx;
+            }
+        }
+
+        void rehash(const size_t size) {
+            std::vector<TSlot> slots(size);
+            slots_.swap(slots);
+            for (TSlot &slot : slots) {
+                if (slot.fp == Fingerprint())
+                    continue;
+
+                slots_[this->findSlot(slot.fp)] = std::move(slot);
+            }
+        }
+};
+
+/// placeholder value for FingerprintMap used as a set
+struct FingerprintNoValue { };
+
+/// set of fingerprints, FingerprintNoValue keeps the slots at 16 bytes
+class FingerprintSet {
+    public:
+        /// insert fp and return true if it was not in the set yet
+        bool insert(const Fingerprint &fp) {
+            bool inserted;
+            map_.lookupOrInsert(fp, &inserted);
+            return inserted;
+        }
+
+        size_t size() const {
+            return map_.size();
+        }
+
+    private:
+        FingerprintMap<FingerprintNoValue>  map_;
+};
+
+#endif /* H_GUARD_FINGERPRINT_H */
@@ -19,39 +19,280 @@
 
 #include "instream.hh"
 
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// /////////////////////////////////////////////////////////////////////////////
+// implementation of InStreamBuf
+
+/// size of the read buffer used for pipes and other special files
+static const size_t inBufSize = 0x100000;
+
+/// number of bytes kept before the get area for putback()
+static const size_t inPutBackSize = 0x10;
+
+class InStreamBuf: public std::streambuf {
+    public:
+        /// take ownership of the given file descriptor
+        InStreamBuf(int fd);
+
+        /// read data from memory owned by the caller
+        InStreamBuf(boost::string_view data);
+
+        ~InStreamBuf() override;
+
+        /// read a line into a view of the internal buffer (or the mapping)
+        bool getLine(boost::string_view *pDst);
+
+        /// return true and the data not read yet if all are available in memory
+        bool mappedData(boost::string_view *pDst) const;
+
+    protected:
+        int_type underflow() override;
+
+    private:
+        const int               fd_;
+        char                   *map_ = nullptr;
+        bool                    ownsMap_ = false;
+        size_t                  mapSize_ = 0;
+        std::vector<char>       buf_;
+        bool                    eof_ = false;
+
+        size_t readMore(size_t off);
+};
+
+InStreamBuf::InStreamBuf(const int fd):
+    fd_(fd)
+{
+    struct stat st;
+    if (!fstat(fd, &st) && S_ISREG(st.st_mode) && 0 < st.st_size) {
+        // regular file -> map the whole file into memory
+        void *addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (MAP_FAILED != addr) {
+            map_ = static_cast<char *>(addr);
+            mapSize_ = st.st_size;
+            ownsMap_ = true;
+            madvise(addr, mapSize_, MADV_SEQUENTIAL);
+            this->setg(map_, map_, map_ + mapSize_);
+            return;
+        }
+    }
+
+    // pipe, empty file, or mmap() failed -> use a large reusable buffer
+    buf_.resize(inBufSize);
+    this->setg(buf_.data(), buf_.data(), buf_.data());
+}
+
+InStreamBuf::InStreamBuf(const boost::string_view data):
+    fd_(-1),
+    // the data is never written to, std::streambuf just does not know const
+    map_(const_cast<char *>(data.data())),
+    mapSize_(data.size())
+{
+    this->setg(map_, map_, map_ + mapSize_);
+}
+
+InStreamBuf::~InStreamBuf()
+{
+    if (ownsMap_)
+        munmap(map_, mapSize_);
+
+    if (0 <= fd_ && STDIN_FILENO != fd_)
+        close(fd_);
+}
+
+bool InStreamBuf::mappedData(boost::string_view *pDst) const
+{
+    if (!map_)
+        return false;
+
+    *pDst = boost::string_view(this->gptr(), this->egptr() - this->gptr());
+    return true;
+}
+
+/// read data from fd_ to buf_ starting at off, return the number of bytes read
+size_t InStreamBuf::readMore(const size_t off)
+{
+    if (eof_)
+        return 0U;
+
+    for (;;) {
+        const ssize_t len = read(fd_, buf_.data() + off, buf_.size() - off);
+        if (0 < len)
+            return len;
+
+        if (len < 0 && EINTR == errno)
+            continue;
+
+        // EOF or read error
+        eof_ = true;
+        return 0U;
+    }
+}
+
+InStreamBuf::int_type InStreamBuf::underflow()
+{
+    if (this->gptr() < this->egptr())
+        return traits_type::to_int_type(*this->gptr());
+
+    if (map_)
+        // the whole file is already available in the get area
+        return traits_type::eof();
+
+    // keep a few bytes at the beginning of the buffer for putback()
+    char *const base = buf_.data();
+    const size_t keep = std::min<size_t>(inPutBackSize, this->gptr() - base);
+    std::memmove(base, this->gptr() - keep, keep);
+
+    const size_t len = this->readMore(keep);
+    this->setg(base, base + keep, base + keep + len);
+    if (!len)
+        return traits_type::eof();
+
+    return traits_type::to_int_type(*this->gptr());
+}
+
+bool InStreamBuf::getLine(boost::string_view *pDst)
+{
+    char *beg = this->gptr();
+    size_t avail = this->egptr() - beg;
+
+    // look for the end of line within the data available in the buffer
+    char *eol = static_cast<char *>(std::memchr(beg, '\n', avail));
+    if (!eol && !map_) {
+        // move the incomplete line to the beginning of the buffer and read more
+        char *base = buf_.data();
+        std::memmove(base, beg, avail);
+        for (;;) {
+            if (buf_.size() == avail) {
+                // the line does not fit into the buffer -> enlarge the buffer
+                buf_.resize(2U * buf_.size());
+                base = buf_.data();
+            }
+
+            const size_t len = this->readMore(avail);
+            if (!len)
+                break;
+
+            eol = static_cast<char *>(std::memchr(base + avail, '\n', len));
+            avail += len;
+            if (eol)
+                break;
+        }
+
+        beg = base;
+        this->setg(base, base, base + avail);
+    }
+
+    if (eol) {
+        // complete line found
+        *pDst = boost::string_view(beg, eol - beg);
+        this->setg(this->eback(), eol + 1, this->egptr());
+        return true;
+    }
+
+    if (!avail)
+        // nothing more to read
+        return false;
+
+    // the last line is not terminated by newline
+    *pDst = boost::string_view(beg, avail);
+    this->setg(this->eback(), beg + avail, this->egptr());
+    return true;
+}
+
+
+// /////////////////////////////////////////////////////////////////////////////
+// implementation of InStream
+
+static int openInput(const std::string &fileName)
+{
+    if (fileName == "-")
+        return STDIN_FILENO;
+
+    return open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+}
+
 InStream::InStream(std::string fileName, const bool silent):
     fileName_(std::move(fileName)),
     silent_(silent),
-    str_((fileName_ == "-")
-                ? std::cin
-                : fileStr_)
+    fileStr_(nullptr),
+    str_(fileStr_)
 {
-    if (&str_ == &fileStr_)
-        fileStr_.open(fileName_);
-
-    if (!fileStr_)
+    const int fd = openInput(fileName_);
+    if (fd < 0)
         throw InFileException(fileName_);
+
+    buf_.reset(new InStreamBuf(fd));
+    fileStr_.rdbuf(buf_.get());
+}
+
+InStream::InStream(
+        const boost::string_view    data,
+        std::string                 fileName,
+        const bool                  silent):
+    fileName_(std::move(fileName)),
+    silent_(silent),
+    buf_(new InStreamBuf(data)),
+    fileStr_(buf_.get()),
+    str_(fileStr_)
+{
 }
 
 InStream::InStream(std::istringstream &str, const bool silent):
     silent_(silent),
+    fileStr_(nullptr),
     str_(str)
 {
 }
 
+InStream::~InStream() = default;
+
+bool InStream::mappedData(boost::string_view *pDst) const
+{
+    return buf_ && buf_->mappedData(pDst);
+}
+
+bool InStream::getLine(boost::string_view *pDst)
+{
+    if (buf_) {
+        if (!fileStr_.good())
+            return false;
+
+        if (buf_->getLine(pDst))
+            return true;
+
+        fileStr_.setstate(std::ios::eofbit | std::ios::failbit);
+        return false;
+    }
+
+    // generic std::istream -> read the line into our own buffer
+    if (!std::getline(str_, line_))
+        return false;
+
+    *pDst = line_;
+    return true;
+}
+
 void InStream::handleError(const std::string &msg, const unsigned long line)
 {
     anyError_ = true;
     if (silent_ || msg.empty())
         return;
 
-    std::cerr << fileName_;
+    *errStr_ << fileName_;
 
     if (line)
         // line number available
-        std::cerr << ":" << line;
+        *errStr_ << ":" << line;
 
-    std::cerr << ": error: " << msg << "\n";
+    *errStr_ << ": error: " << msg << "\n";
 }
 
 InStreamLookAhead::InStreamLookAhead(
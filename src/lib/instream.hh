@@ -20,12 +20,14 @@
 #ifndef H_GUARD_INSTREAM_H
 #define H_GUARD_INSTREAM_H
 
-#include <fstream>
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <vector>
 
+#include <boost/utility/string_view.hpp>
+
 struct InFileException {
     std::string fileName;
     // TODO: details (errno?)
@@ -36,25 +38,51 @@ struct InFileException {
     }
 };
 
+/// stream buffer backed by mmap() for regular files, or by read() otherwise
+class InStreamBuf;
+
 class InStream {
     public:
         InStream(std::string fileName, bool silent = false);
         InStream(std::istringstream &str, bool silent = false);
-        ~InStream() = default;
+
+        /// read data from memory, which needs to outlive the InStream object
+        InStream(boost::string_view data, std::string fileName, bool silent);
+        ~InStream();
 
         const std::string& fileName()   const { return fileName_;   }
         std::istream& str()             const { return str_;        }
         bool silent()                   const { return silent_;     }
         bool anyError()                 const { return anyError_;   }
 
+        /// stream for diagnostic messages about the input, std::cerr by default
+        std::ostream& errStr()          const { return *errStr_;    }
+        void setErrStr(std::ostream *str)     { errStr_ = str;      }
+
+        /// number of threads that parsers are allowed to use for this input
+        unsigned jobs()                 const { return jobs_;       }
+        void setJobs(unsigned jobs)           { jobs_ = jobs;       }
+
         void handleError(const std::string &msg = "", unsigned long line = 0UL);
 
+        /// read a line (without the trailing newline) like std::getline() but
+        /// without copying, the view is valid until the next call of getLine()
+        bool getLine(boost::string_view *pDst);
+
+        /// if the input is mapped into memory, return true and the data that
+        /// have not been read yet
+        bool mappedData(boost::string_view *pDst) const;
+
     private:
-        const std::string   fileName_;
-        const bool          silent_;
-        bool                anyError_ = false;
-        std::ifstream       fileStr_;
-        std::istream       &str_;
+        const std::string               fileName_;
+        const bool                      silent_;
+        bool                            anyError_ = false;
+        std::ostream                   *errStr_ = &std::cerr;
+        unsigned                        jobs_ = 1U;
+        std::unique_ptr<InStreamBuf>    buf_;
+        std::istream                    fileStr_;
+        std::istream                   &str_;
+        std::string                     line_;
 };
 
 class InStreamLookAhead {
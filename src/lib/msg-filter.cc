@@ -21,6 +21,9 @@
 #include "msg-filter.hh"
 #include "regex.hh"
 
+#include <mutex>
+#include <unordered_map>
+
 #include <boost/property_tree/json_parser.hpp>
 
 // Setup verbosity for debugging string substitions while matching them.
@@ -60,11 +63,89 @@ struct MsgReplace {
 
 using TMsgReplaceList = std::vector<MsgReplace>;
 
+/// indexes to TMsgReplaceList of the rules that apply to a given checker
+using TRuleIdxList = std::vector<size_t>;
+
+/// bounded memoizing cache, flushed completely once the limit is reached
+template <class TKey, class TVal, class THash = std::hash<TKey>>
+class MemoCache {
+    public:
+        MemoCache(const size_t limit):
+            limit_(limit)
+        {
+        }
+
+        /// return pointer to the cached value for key, nullptr if not cached
+        const TVal* find(const TKey &key)
+        {
+            const auto it = map_.find(key);
+            if (map_.end() == it) {
+                ++misses_;
+                return nullptr;
+            }
+
+            ++hits_;
+            return &it->second;
+        }
+
+        const TVal& insert(const TKey &key, TVal val)
+        {
+            if (limit_ <= map_.size())
+                // inputs tend to repeat in bursts, so just start over
+                map_.clear();
+
+            return map_[key] = std::move(val);
+        }
+
+        void clear()
+        {
+            map_.clear();
+        }
+
+        unsigned long hits()   const { return hits_;   }
+        unsigned long misses() const { return misses_; }
+
+    private:
+        const size_t                            limit_;
+        std::unordered_map<TKey, TVal, THash>   map_;
+        unsigned long                           hits_   = 0UL;
+        unsigned long                           misses_ = 0UL;
+};
+
+using TMsgKey = std::pair<std::string, std::string>;
+
+struct MsgKeyHash {
+    size_t operator()(const TMsgKey &key) const
+    {
+        const std::hash<std::string> hash;
+        return hash(key.first) * 31U + hash(key.second);
+    }
+};
+
+// maximal number of entries held by each of the memoizing caches
+static const size_t memoCacheLimit = 0x10000;
+
 struct MsgFilter::Private {
     bool ignorePath = false;
     TMsgReplaceList repList;
     TSubstMap fileSubsts;
 
+    /// (checker, msg) -> filtered msg
+    MemoCache<TMsgKey, std::string, MsgKeyHash> msgCache{memoCacheLimit};
+
+    /// raw path -> filtered path
+    MemoCache<std::string, std::string> pathCache{memoCacheLimit};
+
+    /// version string -> compiled regex to kill it from paths
+    MemoCache<std::string, RE> krnCache{memoCacheLimit};
+
+    /// checker -> list of applicable rules (the set of checkers is small)
+    std::unordered_map<std::string, TRuleIdxList> rulesByChecker;
+
+    /// guards the caches above so that multiple threads can filter at once,
+    /// the regexes are matched without holding the lock
+    std::mutex cacheLock;
+
     const std::string strKrn = "^[a-zA-Z+]+";
     const RE reKrn = RE(strKrn);
     const RE reDir = RE("^([^:]*/)");
@@ -80,7 +161,25 @@ struct MsgFilter::Private {
             const std::string          &replacement = "")
     {
         repList.emplace_back(checker, regexp, replacement);
+
+        // the filtering rules have changed
+        flushCaches();
     }
+
+    void flushCaches()
+    {
+        msgCache.clear();
+        pathCache.clear();
+        rulesByChecker.clear();
+    }
+
+    const TRuleIdxList& rulesFor(const std::string &checker);
+
+    std::string filterMsgCore(
+            const std::string          &msg,
+            const std::string          &checker);
+
+    std::string filterPathCore(const std::string &path);
 };
 
 MsgFilter::MsgFilter():
@@ -158,6 +257,7 @@ MsgFilter::~MsgFilter() = default;
 void MsgFilter::setIgnorePath(bool enable)
 {
     d->ignorePath = enable;
+    d->flushCaches();
 }
 
 bool MsgFilter::setFilterFiles(
@@ -215,16 +315,106 @@ void MsgFilter::setFileNameSubstitution(
                 const std::string      &newFile)
 {
     d->fileSubsts[oldFile] = newFile;
+    d->flushCaches();
+}
+
+MsgFilter::CacheStats MsgFilter::cacheStats() const
+{
+    std::lock_guard<std::mutex> guard(d->cacheLock);
+    CacheStats stats;
+    stats.msgHits       = d->msgCache.hits();
+    stats.msgMisses     = d->msgCache.misses();
+    stats.pathHits      = d->pathCache.hits();
+    stats.pathMisses    = d->pathCache.misses();
+    return stats;
+}
+
+Fingerprint MsgFilter::rulesFingerprint() const
+{
+    FingerprintBuilder fpb;
+    fpb.add(d->ignorePath);
+
+    fpb.add(d->repList.size());
+    for (const MsgReplace &rpl : d->repList) {
+        fpb.add(rpl.reChecker.str());
+        fpb.add(rpl.reMsg.str());
+        fpb.add(rpl.replaceWith);
+    }
+
+    fpb.add(d->fileSubsts.size());
+    for (TSubstMap::const_reference item : d->fileSubsts) {
+        fpb.add(item.first);
+        fpb.add(item.second);
+    }
+
+    return fpb.result();
 }
 
 std::string MsgFilter::filterMsg(
         const std::string &msg,
         const std::string &checker) const
 {
+    const TMsgKey key(checker, msg);
+    {
+        std::lock_guard<std::mutex> guard(d->cacheLock);
+        const std::string *cached = d->msgCache.find(key);
+        if (cached)
+            return *cached;
+    }
+
+    std::string filtered = d->filterMsgCore(msg, checker);
+
+    std::lock_guard<std::mutex> guard(d->cacheLock);
+    return d->msgCache.insert(key, std::move(filtered));
+}
+
+std::string MsgFilter::filterPath(const std::string &origPath) const
+{
+    {
+        std::lock_guard<std::mutex> guard(d->cacheLock);
+        const std::string *cached = d->pathCache.find(origPath);
+        if (cached)
+            return *cached;
+    }
+
+    std::string filtered = d->filterPathCore(origPath);
+
+    std::lock_guard<std::mutex> guard(d->cacheLock);
+    return d->pathCache.insert(origPath, std::move(filtered));
+}
+
+const TRuleIdxList& MsgFilter::Private::rulesFor(const std::string &checker)
+{
+    const auto it = this->rulesByChecker.find(checker);
+    if (this->rulesByChecker.end() != it)
+        return it->second;
+
+    // first sight of this checker --> evaluate the checker regexes once
+    TRuleIdxList &rules = this->rulesByChecker[checker];
+    const size_t cnt = this->repList.size();
+    for (size_t idx = 0U; idx < cnt; ++idx)
+        if (boost::regex_search(checker, this->repList[idx].reChecker))
+            rules.push_back(idx);
+
+    return rules;
+}
+
+std::string MsgFilter::Private::filterMsgCore(
+        const std::string &msg,
+        const std::string &checker)
+{
+    TRuleIdxList rules;
+    {
+        // copy the list as the cache may be flushed by another thread
+        std::lock_guard<std::mutex> guard(this->cacheLock);
+        rules = this->rulesFor(checker);
+    }
+
     std::string filtered = msg;
-    for (const MsgReplace &rpl : d->repList)
-        if (boost::regex_search(checker, rpl.reChecker))
-            filtered = regexReplaceWrap(filtered, rpl.reMsg, rpl.replaceWith);
+    for (const size_t idx : rules) {
+        const MsgReplace &rpl = this->repList[idx];
+        filtered = regexReplaceWrap(filtered, rpl.reMsg, rpl.replaceWith);
+    }
 
 #if DEBUG_SUBST > 1
     std::cerr << "filterMsg: " << filtered << "\n";
@@ -232,37 +422,37 @@ std::string MsgFilter::filterMsg(
     return filtered;
 }
 
-std::string MsgFilter::filterPath(const std::string &origPath) const
+std::string MsgFilter::Private::filterPathCore(const std::string &origPath)
 {
     std::string path = origPath;
 
-    TSubstMap &substMap = d->fileSubsts;
+    TSubstMap &substMap = this->fileSubsts;
     if (!substMap.empty()) {
-        std::string base = regexReplaceWrap(origPath, d->reDir, "");
-        std::string dir = regexReplaceWrap(origPath, d->reFile, "");
+        std::string base = regexReplaceWrap(origPath, this->reDir, "");
+        std::string dir = regexReplaceWrap(origPath, this->reFile, "");
         if (substMap.find(base) != substMap.end()) {
             const std::string &substWith = substMap[base];
             path = dir + substWith;
         }
     }
 
-    if (d->ignorePath)
-        return regexReplaceWrap(path, d->reDir, "");
+    if (this->ignorePath)
+        return regexReplaceWrap(path, this->reDir, "");
 
-    if (boost::regex_match(path, d->reTmpPath)) {
+    if (boost::regex_match(path, this->reTmpPath)) {
         // filter random numbers in names of temporary generated files
-        std::string tmpPath = boost::regex_replace(path, d->reTmpCleaner, "/tmp/tmp.c");
+        std::string tmpPath = boost::regex_replace(path, this->reTmpCleaner, "/tmp/tmp.c");
         return tmpPath;
     }
 
     boost::smatch sm;
-    if (boost::regex_match(path, sm, d->rePyBuild)) {
+    if (boost::regex_match(path, sm, this->rePyBuild)) {
         // %{_builddir}/build/lib/setuptools/glob.py ->
         // %{_builddir}/setuptools/glob.py
         path = sm[1] + sm[2];
     }
 
-    if (!boost::regex_match(path, sm, d->rePath))
+    if (!boost::regex_match(path, sm, this->rePath))
         // no match
         return path;
 
@@ -271,8 +461,8 @@ std::string MsgFilter::filterPath(const std::string &origPath) const
 
     // try to kill the multiple version strings in paths (kernel, OpenLDAP, ...)
     nvr.resize(nvr.size() - 1);
-    std::string ver(boost::regex_replace(nvr, d->reKrn, ""));
-    const std::string krnPattern = d->strKrn + ver + "[^/]*/";
+    std::string ver(boost::regex_replace(nvr, this->reKrn, ""));
+    const std::string krnPattern = this->strKrn + ver + "[^/]*/";
 
 #if DEBUG_SUBST > 2
     std::cerr << "nvr: " << nvr << "\n";
@@ -280,7 +470,17 @@ std::string MsgFilter::filterPath(const std::string &origPath) const
     std::cerr << "krnPattern: " << krnPattern << "\n";
 #endif
 
-    const RE reKill(krnPattern);
+    // compile the regex only once per version string, the copy shares the
+    // compiled regex and stays valid if another thread flushes the cache
+    RE reKill;
+    {
+        std::lock_guard<std::mutex> guard(this->cacheLock);
+        const RE *cached = this->krnCache.find(ver);
+        reKill = (cached)
+            ? *cached
+            : this->krnCache.insert(ver, RE(krnPattern));
+    }
+
     core = boost::regex_replace(core, reKill, "");
 
     // quirk for Coverity inconsistency in handling bison-generated file names
@@ -20,6 +20,7 @@
 #ifndef H_GUARD_MSG_FILTER_H
 #define H_GUARD_MSG_FILTER_H
 
+#include "fingerprint.hh"
 #include "instream.hh"
 
 #include <map>
@@ -51,6 +52,20 @@ class MsgFilter {
                 const std::string &checker) const;
         std::string filterPath(const std::string &path) const;
 
+        /// hit/miss counters of the memoizing caches
+        struct CacheStats {
+            unsigned long   msgHits;
+            unsigned long   msgMisses;
+            unsigned long   pathHits;
+            unsigned long   pathMisses;
+        };
+
+        CacheStats cacheStats() const;
+
+        /// fingerprint of the active rules, which changes whenever filterMsg()
+        /// or filterPath() may give a different result for the same input
+        Fingerprint rulesFingerprint() const;
+
     private:
         MsgFilter();
         ~MsgFilter();
@@ -0,0 +1,273 @@
+/*
+ * Copyright (C) 2023 Red Hat, Inc.
+ *
+ * This file is part of csdiff.
+ *
+ * csdiff is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * csdiff is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with csdiff.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "parallel.hh"
+
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+void runOrdered(
+        const unsigned              jobs,
+        const size_t                count,
+        const TTaskFnc             &produce,
+        const TTaskFnc             &consume)
+{
+    if (jobs < 2U || count < 2U) {
+        // nothing to run in parallel
+        for (size_t idx = 0U; idx < count; ++idx) {
+            produce(idx);
+            consume(idx);
+        }
+        return;
+    }
+
+    // do not let the workers get too far ahead of the consumer
+    const size_t window = 2U * jobs;
+
+    std::mutex                          mtx;
+    std::condition_variable             cvDone;
+    std::condition_variable             cvSpace;
+    std::vector<bool>                   done(count, false);
+    std::vector<std::exception_ptr>     errors(count);
+    size_t                              next = 0U;
+    size_t                              consumed = 0U;
+
+    const auto worker = [&]() {
+        for (;;) {
+            size_t idx;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                cvSpace.wait(lock, [&]() {
+                    return (count <= next) || (next < consumed + window);
+                });
+
+                if (count <= next)
+                    // nothing more to do
+                    return;
+
+                idx = next++;
+            }
+
+            std::exception_ptr error;
+            try {
+                produce(idx);
+            }
+            catch (...) {
+                error = std::current_exception();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                errors[idx] = error;
+                done[idx] = true;
+            }
+            cvDone.notify_one();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 0U; i < jobs && i < count; ++i)
+        threads.emplace_back(worker);
+
+    std::exception_ptr error;
+    for (size_t idx = 0U; idx < count && !error; ++idx) {
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cvDone.wait(lock, [&]() { return done[idx]; });
+            error = errors[idx];
+        }
+
+        if (!error) {
+            try {
+                consume(idx);
+            }
+            catch (...) {
+                error = std::current_exception();
+            }
+        }
+
+        {
+            // let the workers continue (or finish in case of error)
+            std::lock_guard<std::mutex> lock(mtx);
+            consumed = idx + 1U;
+            if (error)
+                next = count;
+        }
+        cvSpace.notify_all();
+    }
+
+    for (std::thread &t : threads)
+        t.join();
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
+/// parser replaying the results of another parser that has already finished
+class ReplayParser: public AbstractParser {
+    public:
+        std::vector<Defect>     defList;
+        TScanProps              scanProps;
+        EFileFormat             format = FF_INVALID;
+        bool                    anyError = false;
+
+        bool getNext(Defect *def) override {
+            if (defList.size() <= next_)
+                return false;
+
+            *def = std::move(defList[next_++]);
+            return true;
+        }
+
+        bool hasError() const override {
+            return anyError;
+        }
+
+        const TScanProps& getScanProps() const override {
+            return scanProps;
+        }
+
+        EFileFormat inputFormat() const override {
+            return format;
+        }
+
+    private:
+        size_t                  next_ = 0U;
+};
+
+/// input file parsed in advance by a worker thread
+struct ParsedFile {
+    std::unique_ptr<InStream>       input;
+    std::unique_ptr<ReplayParser>   parser;
+    std::ostringstream              errStr;
+};
+
+static void parseFile(
+        ParsedFile                 *pDst,
+        const std::string          &fileName,
+        const bool                  silent,
+        const TFileCheck           &check,
+        const size_t                idx)
+{
+    try {
+        pDst->input.reset(new InStream(fileName, silent));
+    }
+    catch (const InFileException &) {
+        // reported by the consumer
+        return;
+    }
+
+    InStream &input = *pDst->input;
+    input.setErrStr(&pDst->errStr);
+    if (check && !check(input, idx))
+        // skipped by the consumer as there is no parser
+        return;
+
+    ReplayParser *rp = new ReplayParser;
+    pDst->parser.reset(rp);
+
+    Parser parser(input);
+    rp->format = parser.inputFormat();
+
+    Defect def;
+    while (parser.getNext(&def))
+        rp->defList.push_back(std::move(def));
+
+    // read scan properties once the input is consumed because streamed JSON
+    // input may carry them after the defects
+    rp->scanProps = parser.getScanProps();
+
+    rp->anyError = parser.hasError();
+}
+
+static void printOpenError(const std::string &fileName)
+{
+    std::cerr << fileName << ": failed to open input file\n";
+}
+
+bool parseFiles(
+        const std::vector<std::string> &fileNames,
+        const bool                      silent,
+        const unsigned                  jobs,
+        const TFileHandler             &handler,
+        const TFileCheck               &check)
+{
+    bool ok = true;
+    const size_t count = fileNames.size();
+
+    if (jobs < 2U || count < 2U) {
+        // parse the files sequentially while handling them
+        for (size_t idx = 0U; idx < count; ++idx) {
+            try {
+                InStream input(fileNames[idx], silent);
+
+                // a single input file may still be parsed by chunks in parallel
+                input.setJobs(jobs);
+                if (check && !check(input, idx))
+                    continue;
+
+                Parser parser(input);
+                handler(parser, idx);
+            }
+            catch (const InFileException &e) {
+                printOpenError(e.fileName);
+                ok = false;
+            }
+        }
+
+        return ok;
+    }
+
+    std::vector<ParsedFile> files(count);
+
+    const auto produce = [&](const size_t idx) {
+        parseFile(&files[idx], fileNames[idx], silent, check, idx);
+    };
+
+    const auto consume = [&](const size_t idx) {
+        ParsedFile &pf = files[idx];
+        if (!pf.input) {
+            printOpenError(fileNames[idx]);
+            ok = false;
+            return;
+        }
+
+        // print diagnostic messages of the parser in order
+        std::cerr << pf.errStr.str();
+        pf.input->setErrStr(&std::cerr);
+        if (!pf.parser) {
+            // rejected by the check
+            pf.input.reset();
+            return;
+        }
+
+        Parser parser(*pf.input, AbstractParserPtr(pf.parser.release()));
+        handler(parser, idx);
+
+        // release resources of the input file as soon as possible
+        pf.input.reset();
+        std::ostringstream().swap(pf.errStr);
+    };
+
+    runOrdered(jobs, count, produce, consume);
+    return ok;
+}
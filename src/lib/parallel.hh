@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2023 Red Hat, Inc.
+ *
+ * This file is part of csdiff.
+ *
+ * csdiff is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * csdiff is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with csdiff.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef H_GUARD_PARALLEL_H
+#define H_GUARD_PARALLEL_H
+
+#include "parser.hh"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+using TTaskFnc = std::function<void(size_t idx)>;
+
+/// run produce(0..count-1) on up to jobs worker threads and consume(idx) in
+/// the calling thread in increasing order of idx, each after its produce(idx)
+/// has finished.  Exceptions thrown by produce() are rethrown by consume().
+void runOrdered(
+        unsigned                    jobs,
+        size_t                      count,
+        const TTaskFnc             &produce,
+        const TTaskFnc             &consume);
+
+using TFileHandler = std::function<void(Parser &, size_t idx)>;
+
+/// return false to skip the given input file before it is parsed, may be
+/// called from worker threads and may report errors via input.handleError()
+using TFileCheck = std::function<bool(InStream &, size_t idx)>;
+
+/// open and parse the given input files using up to jobs threads and pass
+/// them to handler in their original order.  Diagnostic messages of parsers
+/// are printed to std::cerr in the same order.  With jobs < 2, files are
+/// parsed sequentially while being handled.  Files rejected by the optional
+/// check are not passed to handler.
+///
+/// @return false if any of the input files could not be opened
+bool parseFiles(
+        const std::vector<std::string> &fileNames,
+        bool                            silent,
+        unsigned                        jobs,
+        const TFileHandler             &handler,
+        const TFileCheck               &check = TFileCheck());
+
+#endif /* H_GUARD_PARALLEL_H */
@@ -0,0 +1,394 @@
+/*
+ * Copyright (C) 2023 Red Hat, Inc.
+ *
+ * This file is part of csdiff.
+ *
+ * csdiff is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * csdiff is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with csdiff.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "parser-binary.hh"
+
+#include "binary-format.hh"
+#include "defect-pool.hh"
+
+#include <algorithm>
+#include <deque>
+#include <limits>
+
+using namespace BinaryFormat;
+
+struct BinaryParser::Private {
+    InStream                           &input;
+    std::istream                       &str;
+
+    /// if the input is mapped into memory, strings are not copied while
+    /// decoding and the string table refers directly to the mapped data
+    boost::string_view                  data;
+    bool                                mapped;
+    size_t                              pos = 0U;
+
+    std::vector<boost::string_view>     strTab;
+
+    /// symbols interned on demand for the entries of strTab
+    std::vector<Symbol>                 symTab;
+    std::deque<std::string>             strStore;
+    TScanProps                          scanProps;
+    DefPool                             pool;
+    bool                                hasError = false;
+    bool                                done = false;
+
+    Private(InStream &input_):
+        input(input_),
+        str(input_.str()),
+        mapped(input_.mappedData(&data))
+    {
+    }
+
+    void handleError(const char *msg);
+    bool peekByte(int *pDst);
+    bool readByte(int *pDst);
+    bool readVarInt(uint64_t *pDst);
+    bool readInt(int *pDst);
+    bool readStrIdx(size_t *pIdx);
+    bool readStr(std::string *pDst);
+    bool readStr(Symbol *pDst);
+    bool readInlineStr(std::string *pDst);
+    bool readHead();
+    bool readScanProps();
+    bool readEvent(DefEvent *pEvt);
+    bool readDefect(Defect *pDef);
+};
+
+void BinaryParser::Private::handleError(const char *msg)
+{
+    input.handleError(msg);
+    hasError = true;
+    done = true;
+}
+
+bool BinaryParser::Private::peekByte(int *pDst)
+{
+    if (mapped) {
+        if (data.size() <= pos)
+            return false;
+
+        *pDst = static_cast<unsigned char>(data[pos]);
+        return true;
+    }
+
+    const int c = str.peek();
+    if (std::istream::traits_type::eof() == c)
+        return false;
+
+    *pDst = c;
+    return true;
+}
+
+bool BinaryParser::Private::readByte(int *pDst)
+{
+    if (!this->peekByte(pDst))
+        return false;
+
+    if (mapped)
+        ++pos;
+    else
+        str.get();
+
+    return true;
+}
+
+bool BinaryParser::Private::readVarInt(uint64_t *pDst)
+{
+    uint64_t num = 0U;
+    for (unsigned shift = 0U; shift < 64U; shift += 7U) {
+        int c;
+        if (!this->readByte(&c))
+            return false;
+
+        num |= static_cast<uint64_t>(c & 0x7F) << shift;
+        if (!(c & 0x80)) {
+            *pDst = num;
+            return true;
+        }
+    }
+
+    // too many bytes for a 64-bit integer
+    return false;
+}
+
+bool BinaryParser::Private::readInt(int *pDst)
+{
+    uint64_t raw;
+    if (!this->readVarInt(&raw))
+        return false;
+
+    const int64_t num = zigZagDecode(raw);
+    if (num < std::numeric_limits<int>::min()
+            || std::numeric_limits<int>::max() < num)
+        return false;
+
+    *pDst = static_cast<int>(num);
+    return true;
+}
+
+/// read a string and return its index to the string table
+bool BinaryParser::Private::readStrIdx(size_t *pIdx)
+{
+    uint64_t idx;
+    if (!this->readVarInt(&idx))
+        return false;
+
+    if (idx) {
+        // string already in the string table
+        if (strTab.size() < idx)
+            return false;
+
+        *pIdx = idx - 1U;
+        return true;
+    }
+
+    uint64_t len;
+    if (!this->readVarInt(&len))
+        return false;
+
+    boost::string_view sv;
+    if (mapped) {
+        if (data.size() - pos < len)
+            return false;
+
+        sv = data.substr(pos, len);
+        pos += len;
+    }
+    else {
+        // read the string in chunks so that a corrupted length does not
+        // make us allocate a lot of memory for nothing
+        std::string buf;
+        while (buf.size() < len) {
+            char chunk[0x10000];
+            const size_t want = std::min<uint64_t>(len - buf.size(), sizeof chunk);
+            if (!str.read(chunk, want))
+                return false;
+
+            buf.append(chunk, want);
+        }
+
+        strStore.push_back(std::move(buf));
+        sv = strStore.back();
+    }
+
+    *pIdx = strTab.size();
+    strTab.push_back(sv);
+    symTab.emplace_back();
+    return true;
+}
+
+bool BinaryParser::Private::readStr(std::string *pDst)
+{
+    size_t idx;
+    if (!this->readStrIdx(&idx))
+        return false;
+
+    const boost::string_view sv = strTab[idx];
+    pDst->assign(sv.data(), sv.size());
+    return true;
+}
+
+bool BinaryParser::Private::readStr(Symbol *pDst)
+{
+    size_t idx;
+    if (!this->readStrIdx(&idx))
+        return false;
+
+    // intern each string at most once
+    Symbol &sym = symTab[idx];
+    if (sym.empty())
+        sym = strTab[idx];
+
+    *pDst = sym;
+    return true;
+}
+
+/// read a string that is not in the string table
+bool BinaryParser::Private::readInlineStr(std::string *pDst)
+{
+    uint64_t len;
+    if (!this->readVarInt(&len))
+        return false;
+
+    if (mapped) {
+        if (data.size() - pos < len)
+            return false;
+
+        pDst->assign(data.data() + pos, len);
+        pos += len;
+        return true;
+    }
+
+    // read the string in chunks so that a corrupted length does not make us
+    // allocate a lot of memory for nothing
+    pDst->clear();
+    while (pDst->size() < len) {
+        char chunk[0x10000];
+        const size_t want = std::min<uint64_t>(len - pDst->size(), sizeof chunk);
+        if (!str.read(chunk, want))
+            return false;
+
+        pDst->append(chunk, want);
+    }
+
+    return true;
+}
+
+bool BinaryParser::Private::readHead()
+{
+    for (unsigned i = 0U; i < magicSize; ++i) {
+        int c;
+        if (!this->readByte(&c) || static_cast<unsigned char>(magic[i]) != c)
+            return false;
+    }
+
+    uint64_t ver;
+    return this->readVarInt(&ver)
+        && version == ver;
+}
+
+bool BinaryParser::Private::readScanProps()
+{
+    uint64_t cnt;
+    if (!this->readVarInt(&cnt))
+        return false;
+
+    scanProps.clear();
+    for (uint64_t i = 0U; i < cnt; ++i) {
+        std::string key, val;
+        if (!this->readStr(&key) || !this->readInlineStr(&val))
+            return false;
+
+        scanProps[key] = std::move(val);
+    }
+
+    return true;
+}
+
+bool BinaryParser::Private::readEvent(DefEvent *pEvt)
+{
+    return this->readStr(&pEvt->fileName)
+        && this->readInt(&pEvt->line)
+        && this->readInt(&pEvt->column)
+        && this->readStr(&pEvt->event)
+        && this->readInlineStr(&pEvt->msg)
+        && this->readInt(&pEvt->verbosityLevel);
+}
+
+bool BinaryParser::Private::readDefect(Defect *pDef)
+{
+    uint64_t keyEventIdx;
+    if (!this->readStr(&pDef->checker)
+            || !this->readInlineStr(&pDef->annotation)
+            || !this->readInlineStr(&pDef->function)
+            || !this->readStr(&pDef->language)
+            || !this->readStr(&pDef->tool)
+            || !this->readVarInt(&keyEventIdx)
+            || !this->readInt(&pDef->cwe)
+            || !this->readInt(&pDef->imp)
+            || !this->readInt(&pDef->defectId))
+        return false;
+
+    uint64_t evtCnt;
+    if (!this->readVarInt(&evtCnt))
+        return false;
+
+    if (evtCnt <= keyEventIdx)
+        // key event out of range, or no events at all
+        return false;
+
+    pDef->keyEventIdx = keyEventIdx;
+
+    // reuse the memory of the events of the previous defect, one event at
+    // a time so that a corrupted count cannot make us allocate a lot of memory
+    TEvtList &evtList = pDef->events;
+    pool.resizeEvents(&evtList, 0U);
+    for (uint64_t i = 0U; i < evtCnt; ++i) {
+        pool.resizeEvents(&evtList, i + 1U);
+        if (!this->readEvent(&evtList.back()))
+            return false;
+    }
+
+    return true;
+}
+
+BinaryParser::BinaryParser(InStream &input):
+    d(new Private(input))
+{
+    if (!d->readHead()) {
+        d->handleError("invalid header of binary data");
+        return;
+    }
+
+    // read scan properties written before the first defect
+    int c;
+    while (d->peekByte(&c) && TAG_SCAN_PROPS == c) {
+        d->readByte(&c);
+        if (!d->readScanProps()) {
+            d->handleError("invalid scan properties in binary data");
+            return;
+        }
+    }
+}
+
+BinaryParser::~BinaryParser() = default;
+
+bool BinaryParser::getNext(Defect *pDef)
+{
+    while (!d->done) {
+        int tag;
+        if (!d->readByte(&tag)) {
+            d->handleError("unexpected end of binary data");
+            break;
+        }
+
+        switch (tag) {
+            case TAG_DEFECT:
+                if (d->readDefect(pDef))
+                    return true;
+
+                d->handleError("invalid defect in binary data");
+                break;
+
+            case TAG_SCAN_PROPS:
+                if (!d->readScanProps())
+                    d->handleError("invalid scan properties in binary data");
+                break;
+
+            case TAG_END:
+                d->done = true;
+                break;
+
+            default:
+                d->handleError("unknown record in binary data");
+        }
+    }
+
+    return false;
+}
+
+bool BinaryParser::hasError() const
+{
+    return d->hasError;
+}
+
+const TScanProps& BinaryParser::getScanProps() const
+{
+    return d->scanProps;
+}
@@ -21,6 +21,8 @@
 
 #include "regex.hh"
 
+#include <unordered_map>
+
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/lexical_cast.hpp>
@@ -36,12 +38,55 @@ int parse_int(const std::string &str, const int fallback)
 }
 
 struct ImpliedAttrDigger::Private {
-    typedef std::map<std::string, std::string>      TMap;
+    typedef std::unordered_map<std::string, std::string>    TMap;
     TMap langByChecker;
 
+    /// attributes inferred from a checker, computed on its first sight
+    struct CheckerAttrs {
+        std::string                 lang;   ///< empty if not known
+        std::string                 tool;
+    };
+
+    typedef std::unordered_map<std::string, CheckerAttrs>   TAttrsMap;
+    TAttrsMap attrsByChecker;
+
     const RE reToolWarning = RE("^([A-Z_]+)_WARNING$");
+
+    const CheckerAttrs& lookup(const std::string &checker);
 };
 
+const ImpliedAttrDigger::Private::CheckerAttrs&
+ImpliedAttrDigger::Private::lookup(const std::string &checker)
+{
+    const TAttrsMap::const_iterator it = this->attrsByChecker.find(checker);
+    if (this->attrsByChecker.end() != it)
+        return it->second;
+
+    CheckerAttrs attrs;
+
+    TMap::const_iterator itLang = this->langByChecker.find(checker);
+    if (this->langByChecker.end() != itLang)
+        attrs.lang = itLang->second;
+
+    boost::smatch sm;
+    if (boost::regex_match(checker, sm, this->reToolWarning)) {
+        // extract tool="gcc-analyzer" out of checker="GCC_ANALYZER_WARNING"
+        std::string &tool = attrs.tool;
+        tool = sm[/* tool */ 1];
+        boost::algorithm::to_lower(tool);
+        boost::algorithm::replace_all(tool, "_", "-");
+
+        if (tool == "compiler")
+            // we use COMPILER_WARNING for "gcc" due to historical reasons
+            tool = "gcc";
+    }
+    else
+        // no tool matched --> assume coverity
+        attrs.tool = "coverity";
+
+    return this->attrsByChecker[checker] = std::move(attrs);
+}
+
 ImpliedAttrDigger::ImpliedAttrDigger():
     d(new Private)
 {
@@ -68,13 +113,13 @@ void ImpliedAttrDigger::inferLangFromChecker(
         // language already assigned
         return;
 
-    Private::TMap::const_iterator it = d->langByChecker.find(pDef->checker);
-    if (d->langByChecker.end() == it)
+    const std::string &lang = d->lookup(pDef->checker).lang;
+    if (lang.empty())
         // not found
         return;
 
     // found --> assign from map
-    pDef->language = it->second;
+    pDef->language = lang;
 }
 
 void ImpliedAttrDigger::inferToolFromChecker(
@@ -86,20 +131,11 @@ void ImpliedAttrDigger::inferToolFromChecker(
         // tool already assigned
         return;
 
-    boost::smatch sm;
-    if (boost::regex_match(pDef->checker, sm, d->reToolWarning)) {
-        // extract tool="gcc-analyzer" out of checker="GCC_ANALYZER_WARNING"
-        std::string tool = sm[/* tool */ 1];
-        boost::algorithm::to_lower(tool);
-        boost::algorithm::replace_all(tool, "_", "-");
-
-        if (tool == "compiler")
-            // we use COMPILER_WARNING for "gcc" due to historical reasons
-            tool = "gcc";
+    pDef->tool = this->toolByChecker(pDef->checker);
+}
 
-        pDef->tool = tool;
-    }
-    else
-        // no tool matched --> assume coverity
-        pDef->tool = "coverity";
+const std::string& ImpliedAttrDigger::toolByChecker(const std::string &checker)
+    const
+{
+    return d->lookup(checker).tool;
 }
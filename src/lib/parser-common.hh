@@ -47,6 +47,9 @@ class ImpliedAttrDigger {
         void inferLangFromChecker(Defect *, bool onlyIfMissing = true) const;
         void inferToolFromChecker(Defect *, bool onlyIfMissing = true) const;
 
+        /// tool implied by the given checker, the result is cached per checker
+        const std::string& toolByChecker(const std::string &checker) const;
+
     private:
         struct Private;
         Private *d;
@@ -19,6 +19,7 @@
 
 #include "parser-cov.hh"
 
+#include "defect-pool.hh"
 #include "parser-common.hh"
 #include "regex.hh"
 
@@ -35,7 +36,7 @@ namespace CovParserImpl {
 
 class LineReader {
     public:
-        LineReader(std::istream &input):
+        LineReader(InStream &input):
             input_(input)
         {
         }
@@ -47,41 +48,54 @@ class LineReader {
         bool getLine(std::string *pDst);
 
     private:
-        std::istream               &input_;
+        InStream                   &input_;
         int                         lineNo_ = 0;
 
+        std::string                 nextLine_;
+
         const RE reTrailLoc_ = RE("^(path:|/).*(:[0-9]+|<.*>):$");
-        const RE rePathPref_ = RE("^path:");
 
         bool getLinePriv(std::string *pDst);
+        bool hasTrailLoc(const std::string &line) const;
 };
 
 bool LineReader::getLinePriv(std::string *pDst)
 {
-    if (!std::getline(input_, *pDst))
+    boost::string_view line;
+    if (!input_.getLine(&line))
         return false;
 
+    pDst->assign(line.data(), line.size());
     lineNo_++;
     return true;
 }
 
+bool LineReader::hasTrailLoc(const std::string &line) const
+{
+    // cheap checks first, most of the lines do not end with ':'
+    if (line.empty() || line.back() != ':')
+        return false;
+
+    if (line[0] != '/' && !boost::starts_with(line, "path:"))
+        return false;
+
+    return boost::regex_search(line, reTrailLoc_);
+}
+
 bool LineReader::getLine(std::string *pDst)
 {
-    std::string line;
-    if (!this->getLinePriv(&line))
+    if (!this->getLinePriv(pDst))
         return false;
 
-    std::string nextLine;
-    while (boost::regex_search(line, reTrailLoc_)
-            && this->getLinePriv(&nextLine))
-    {
+    while (this->hasTrailLoc(*pDst) && this->getLinePriv(&nextLine_)) {
         // merge the current line with the next line
-        nextLine.insert(/* pos */ 0U, " ");
-        line += nextLine;
+        pDst->push_back(' ');
+        pDst->append(nextLine_);
     }
 
     // remove the "path:" prefix if matched
-    *pDst = boost::regex_replace(line, rePathPref_, "");
+    if (boost::starts_with(*pDst, "path:"))
+        pDst->erase(/* pos */ 0U, /* len */ 5U);
 
     return true;
 }
@@ -111,7 +125,7 @@ std::ostream& operator<<(std::ostream &str, EToken code)
 
 class ErrFileLexer {
     public:
-        ErrFileLexer(std::istream &input):
+        ErrFileLexer(InStream &input):
             lineReader_(input),
             hasError_(false)
         {
@@ -141,8 +155,9 @@ class ErrFileLexer {
         Defect                      def_;
         DefEvent                    evt_;
 
-        const RE reEmpty_ =
-            RE("^ *$");
+        // reused for each line to avoid heap allocations
+        std::string                 line_;
+        boost::smatch               sm_;
 
         const RE reComment_ =
             RE("^(#)(.*)$");
@@ -157,25 +172,29 @@ class ErrFileLexer {
 
 EToken ErrFileLexer::readNext()
 {
-    std::string line;
+    std::string &line = line_;
     if (!lineReader_.getLine(&line))
         return T_NULL;
 
-    if (boost::regex_match(line, reEmpty_))
+    if (std::string::npos == line.find_first_not_of(' '))
         return T_EMPTY;
 
-    boost::smatch sm;
+    boost::smatch &sm = sm_;
 
     if (boost::regex_match(line, sm, reChecker_)) {
-        def_ = Defect(sm[/* checker */ 1]);
-        def_.annotation = sm[/* annotation */ 2];
+        // only the checker and annotation are ever set in def_
+        def_.checker = toSymbol(sm[/* checker */ 1]);
+        assignSubMatch(&def_.annotation, sm[/* annotation */ 2]);
         return T_CHECKER;
     }
 
     if (boost::regex_match(line, sm, reComment_)) {
-        evt_ = DefEvent();
-        evt_.event  = sm[/* #     */ 1];
-        evt_.msg    = sm[/* msg   */ 2];
+        evt_.fileName   = Symbol();
+        evt_.line       = 0;
+        evt_.column     = 0;
+        evt_.event      = toSymbol(sm[/* #     */ 1]);
+        assignSubMatch(&evt_.msg, sm[/* msg   */ 2]);
+        evt_.verbosityLevel = 0;
         return T_COMMENT;
     }
 
@@ -185,9 +204,9 @@ EToken ErrFileLexer::readNext()
     }
 
     // read file name, event, and msg
-    evt_.fileName   = sm[/* file  */ 1];
-    evt_.event      = sm[/* event */ 4];
-    evt_.msg        = sm[/* msg   */ 5];
+    evt_.fileName   = toSymbol(sm[/* file  */ 1]);
+    evt_.event      = toSymbol(sm[/* event */ 4]);
+    assignSubMatch(&evt_.msg, sm[/* msg   */ 5]);
 
     // parse line number
     evt_.line = parse_int(sm[/* line */ 2]);
@@ -207,20 +226,41 @@ struct KeyEventDigger::Private {
     typedef std::map<std::string, TSet>             TMap;
     TMap hMap;
     TSet denyList, traceEvts;
-    const RE reEvtSuffix = RE("^(.*)\\[[^ \\]]+\\]$");
-    const std::string stripEvtName(const std::string &) const;
+
+    // reused for each defect to avoid heap allocations
+    std::string lowerChecker;
+    std::string evtName;
+
+    void stripEvtName(std::string *pDst, const std::string &evt) const;
 };
 
-/// strip the [-W...] suffix from event name
-const std::string KeyEventDigger::Private::stripEvtName(const std::string &evt)
+/// strip the [-W...] suffix from event name, same as s/^(.*)\[[^ \]]+\]$/\1/
+void KeyEventDigger::Private::stripEvtName(
+        std::string                *pDst,
+        const std::string          &evt)
     const
 {
-    boost::smatch sm;
-    if (boost::regex_match(evt, sm, this->reEvtSuffix))
-        return sm[/* bare evt */ 1];
+    const size_t len = evt.size();
+    if (len < 3U || evt[len - 1U] != ']') {
+        // no suffix
+        pDst->assign(evt);
+        return;
+    }
+
+    // look for the last '[' followed by a non-empty suffix without ' ' or ']'
+    for (size_t i = len - 1U; 0U < i--;) {
+        const char c = evt[i];
+        if (c == ' ' || c == ']')
+            break;
+
+        if (c == '[' && i + 2U < len) {
+            pDst->assign(evt, /* pos */ 0U, /* len */ i);
+            return;
+        }
+    }
 
     // no match
-    return evt;
+    pDst->assign(evt);
 }
 
 KeyEventDigger::KeyEventDigger():
@@ -338,15 +378,13 @@ bool KeyEventDigger::guessKeyEvent(Defect *def)
         return false;
 
     const unsigned evtCount = evtList.size();
-    Private::TSet defKeyEvent;
-    const Private::TSet *pKeyEvents = &defKeyEvent;
+    const Private::TSet *pKeyEvents = nullptr;
 
     Private::TMap::const_iterator it = d->hMap.find(def->checker);
     if (d->hMap.end() == it) {
         // no override for the checker -> match the lowered checker name
-        std::string str(def->checker);
-        boost::algorithm::to_lower(str);
-        defKeyEvent.insert(str);
+        d->lowerChecker.assign(def->checker.str());
+        boost::algorithm::to_lower(d->lowerChecker);
     }
     else
         // use the corresponding set of events from d->hMap
@@ -354,8 +392,11 @@ bool KeyEventDigger::guessKeyEvent(Defect *def)
 
     for (int idx = evtCount - 1U; idx >= 0; --idx) {
         const DefEvent &evt = evtList[idx];
-        const std::string evtName = d->stripEvtName(evt.event);
-        if (!pKeyEvents->count(evtName))
+        d->stripEvtName(&d->evtName, evt.event);
+        const bool matched = (pKeyEvents)
+            ? !!pKeyEvents->count(d->evtName)
+            : (d->evtName == d->lowerChecker);
+        if (!matched)
             continue;
 
         // matched
@@ -408,11 +449,16 @@ class AnnotHandler {
 
     private:
         const RE reCweAnnot_ = RE("^ *\\(CWE-([0-9]+)\\)$");
+        boost::smatch sm_;
 };
 
 void AnnotHandler::handleDef(Defect *pDef)
 {
-    boost::smatch sm;
+    if (pDef->annotation.empty())
+        // nothing to match
+        return;
+
+    boost::smatch &sm = sm_;
     if (boost::regex_match(pDef->annotation, sm, reCweAnnot_)) {
         pDef->cwe = parse_int(sm[/* cwe */ 1]);
         pDef->annotation.clear();
@@ -421,6 +467,7 @@ void AnnotHandler::handleDef(Defect *pDef)
 
 struct CovParser::Private {
     ErrFileLexer            lexer;
+    std::ostream           &errStr;
     std::string             fileName;
     const bool              silent;
     bool                    hasError;
@@ -428,9 +475,11 @@ struct CovParser::Private {
     KeyEventDigger          keDigger;
     AnnotHandler            annotHdl;
     ImpliedAttrDigger       digger;
+    DefPool                 pool;
 
     Private(InStream &input_):
-        lexer(input_.str()),
+        lexer(input_),
+        errStr(input_.errStr()),
         fileName(input_.fileName()),
         silent(input_.silent()),
         hasError(false),
@@ -440,6 +489,7 @@ struct CovParser::Private {
 
     void parseError(const std::string &msg);
     void wrongToken(EToken expected = T_NULL);
+    void captureEvt(TEvtList *pEvtList);
     bool seekForToken(EToken, TEvtList *pEvtList);
     bool parseMsg(TEvtList *pEvtList);
     bool parseNext(Defect *);
@@ -467,7 +517,7 @@ void CovParser::Private::parseError(const std::string &msg)
     if (this->silent)
         return;
 
-    std::cerr << this->fileName
+    this->errStr << this->fileName
         << ":" << this->lexer.lineNo()
         << ": parse error: " << msg << "\n";
 }
@@ -481,6 +531,13 @@ void CovParser::Private::wrongToken(const EToken expected)
     this->parseError(str.str());
 }
 
+/// append a copy of the current event, reusing the memory of pooled events
+void CovParser::Private::captureEvt(TEvtList *pEvtList)
+{
+    this->pool.resizeEvents(pEvtList, pEvtList->size() + 1U);
+    pEvtList->back() = this->lexer.evt();
+}
+
 bool CovParser::Private::seekForToken(const EToken token, TEvtList *pEvtList)
 {
     for (;;) {
@@ -500,7 +557,7 @@ bool CovParser::Private::seekForToken(const EToken token, TEvtList *pEvtList)
 
             case T_COMMENT:
                 // capture a comment event
-                pEvtList->push_back(this->lexer.evt());
+                this->captureEvt(pEvtList);
                 break;
 
             case T_CHECKER:
@@ -529,7 +586,7 @@ bool CovParser::Private::parseMsg(TEvtList *pEvtList)
         return false;
     }
 
-    pEvtList->push_back(this->lexer.evt());
+    this->captureEvt(pEvtList);
 
     // parse extra msg
     for (;;) {
@@ -544,7 +601,7 @@ bool CovParser::Private::parseMsg(TEvtList *pEvtList)
 
             case T_COMMENT:
                 // capture a comment event
-                pEvtList->push_back(this->lexer.evt());
+                this->captureEvt(pEvtList);
                 anyComment = true;
                 continue;
 
@@ -569,13 +626,16 @@ fail:
 
 bool CovParser::Private::parseNext(Defect *def)
 {
+    // reuse the memory of the previously parsed defect
+    this->pool.reset(def);
+
     // parse defect header
-    TEvtList evtList;
-    if (!this->seekForToken(T_CHECKER, &evtList))
+    if (!this->seekForToken(T_CHECKER, &def->events))
         return false;
 
-    *def = this->lexer.def();
-    def->events.swap(evtList);
+    const Defect &defHead = this->lexer.def();
+    def->checker = defHead.checker;
+    def->annotation = defHead.annotation;
 
     // parse defect body
     this->code = this->lexer.readNext();
@@ -597,7 +657,7 @@ bool CovParser::Private::parseNext(Defect *def)
 
             case T_COMMENT:
                 // capture a comment event
-                def->events.push_back(this->lexer.evt());
+                this->captureEvt(&def->events);
                 this->code = this->lexer.readNext();
                 continue;
 
@@ -23,6 +23,11 @@
 #include "regex.hh"
 
 #include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <limits>
 
 namespace GccParserImpl {
 
@@ -67,7 +72,7 @@ class AbstractTokenFilter: public ITokenizer {
 
 class Tokenizer: public ITokenizer {
     public:
-        Tokenizer(std::istream &input):
+        Tokenizer(InStream &input):
             input_(input),
             lineNo_(0)
         {
@@ -79,26 +84,20 @@ class Tokenizer: public ITokenizer {
 
         EToken readNext(DefEvent *pEvt) override;
 
+        /// classify the given line as if it was read by readNext()
+        EToken classify(DefEvent *pEvt, boost::string_view line);
+
     private:
-        std::istream           &input_;
+        InStream               &input_;
         int                     lineNo_;
 
-        const RE reSideBar_ =
-            RE("^ *((([0-9]+)? \\| )|(\\+\\+\\+ \\|\\+)).*$");
-
-        const RE reMarker_ =
-            RE("^ *[ ~^|]+$");
-
+        // the most frequent line formats are recognized by the hand-written
+        // scanner below, the regexes are used only for lines that pass the
+        // cheap checks in readNext()
         const RE reInc_ =
             RE("^(?:In file included| +) from " RE_LOCATION "[:,]"
                 RE_TOOL_SUFFIX);
 
-        const RE reScope_ =
-            RE("^" RE_LOCATION ": ([A-Z].+):" RE_TOOL_SUFFIX);
-
-        const RE reMsg_ =
-            RE("^" RE_LOCATION /* evt/msg */ ": (" RE_EVENT "): (.*)$");
-
         const RE reSmatch_ =
             RE("^(?<file>[^:]+):(?<line>[0-9]+)() "  /* file:line */
                 RE_FNC_SMATCH                        /* fnc       */
@@ -112,69 +111,330 @@ class Tokenizer: public ITokenizer {
                "(?: \\(BuildId: [[:xdigit:]]+\\))?$");
 };
 
+static inline bool isDigit(const char c)
+{
+    return ('0' <= c) && (c <= '9');
+}
+
+static inline bool isUpper(const char c)
+{
+    return ('A' <= c) && (c <= 'Z');
+}
+
+static inline bool isAlpha(const char c)
+{
+    return isUpper(c) || (('a' <= c) && (c <= 'z'));
+}
+
+static inline bool isWordChar(const char c)
+{
+    return isAlpha(c) || isDigit(c) || ('_' == c) || ('-' == c);
+}
+
+template <size_t N>
+static inline bool hasPrefix(const char *p, const char *end, const char (&lit)[N])
+{
+    return (static_cast<size_t>(end - p) >= N - 1)
+        && !std::memcmp(p, lit, N - 1);
+}
+
+static inline const char* skipDigits(const char *p, const char *end)
+{
+    while (p != end && isDigit(*p))
+        ++p;
+
+    return p;
+}
+
+/// same as parse_int() for strings consisting of decimal digits only
+static int parseDigits(const char *p, const char *end)
+{
+    if (p == end)
+        // parse_int() falls back to 0 on empty input
+        return 0;
+
+    long long val = 0LL;
+    for (; p != end; ++p) {
+        val = 10LL * val + (*p - '0');
+        if (std::numeric_limits<int>::max() < val)
+            // parse_int() falls back to 0 on overflow
+            return 0;
+    }
+
+    return static_cast<int>(val);
+}
+
+/// match ^ *((([0-9]+)? \| )|(\+\+\+ \|\+)).*$
+static bool matchSideBar(const char *beg, const char *end)
+{
+    const char *p = beg;
+    while (p != end && ' ' == *p)
+        ++p;
+
+    if (beg < p && hasPrefix(p, end, "| "))
+        // the last leading space belongs to " | "
+        return true;
+
+    const char *q = skipDigits(p, end);
+    if (p < q && hasPrefix(q, end, " | "))
+        return true;
+
+    return hasPrefix(p, end, "+++ |+");
+}
+
+/// match ^ *[ ~^|]+$
+static bool matchMarker(const char *beg, const char *end)
+{
+    if (beg == end)
+        return false;
+
+    for (const char *p = beg; p != end; ++p) {
+        switch (*p) {
+            case ' ':
+            case '~':
+            case '^':
+            case '|':
+                continue;
+
+            default:
+                return false;
+        }
+    }
+
+    return true;
+}
+
+/// location of a message as matched by ^RE_LOCATION": "
+struct LineLoc {
+    const char *fileEnd;
+    const char *lineBeg = nullptr;
+    const char *lineEnd = nullptr;
+    const char *colBeg  = nullptr;
+    const char *colEnd  = nullptr;
+
+    /// position right after the trailing ": "
+    const char *rest;
+};
+
+static bool scanLocation(LineLoc *pLoc, const char *beg, const char *end)
+{
+    // the file name cannot contain ':', so it ends with the first ':'
+    const char *p = static_cast<const char *>(std::memchr(beg, ':', end - beg));
+    if (!p || p - beg < 2)
+        return false;
+
+    switch (*beg) {
+        case ' ':
+        case '#':
+        case '"':
+            return false;
+    }
+
+    if (std::memchr(beg, '"', p - beg))
+        return false;
+
+    pLoc->fileEnd = p;
+
+    // optional ":line" and ":col"
+    const char **ppBeg[] = { &pLoc->lineBeg, &pLoc->colBeg };
+    const char **ppEnd[] = { &pLoc->lineEnd, &pLoc->colEnd };
+    for (int i = 0; i < 2; ++i) {
+        if (end - p < 2 || ':' != p[0] || !isDigit(p[1]))
+            break;
+
+        *ppBeg[i] = p + 1;
+        *ppEnd[i] = p = skipDigits(p + 1, end);
+    }
+
+    if (!hasPrefix(p, end, ": "))
+        return false;
+
+    pLoc->rest = p + /* ": " */ 2;
+    return true;
+}
+
+/// match (RE_EVENT): at p, return end of the event or nullptr if not matched
+static const char* scanEvent(const char *p, const char *end)
+{
+    // optional prefix of the event
+    if (hasPrefix(p, end, "fatal "))
+        p += sizeof "fatal " - 1;
+    else if (hasPrefix(p, end, "internal "))
+        p += sizeof "internal " - 1;
+    else if (hasPrefix(p, end, "runtime "))
+        p += sizeof "runtime " - 1;
+
+    // [A-Za-z][A-Za-z0-9_-]+
+    if (p == end || !isAlpha(*p))
+        return nullptr;
+
+    const char *q = p + 1;
+    while (q != end && isWordChar(*q))
+        ++q;
+
+    if (q - p < 2)
+        return nullptr;
+
+    // optional \[[^ \]]+\]
+    if (q != end && '[' == *q) {
+        const char *r = q + 1;
+        while (r != end && ' ' != *r && ']' != *r)
+            ++r;
+
+        if (r == q + 1 || r == end || ']' != *r)
+            return nullptr;
+
+        q = r + 1;
+    }
+
+    // RE_EVENT_PROSPECTOR matches a subset of what is matched above
+    return (hasPrefix(q, end, ": "))
+        ? q
+        : nullptr;
+}
+
+/// match ([A-Z].+):RE_TOOL_SUFFIX at p, return end of msg or nullptr
+static const char* scanScopeMsg(const char *p, const char *end)
+{
+    if (p == end || !isUpper(*p))
+        return nullptr;
+
+    // the greedy .+ makes the regex match the last suitable ':'
+    const char *msgEnd = nullptr;
+    if (':' == end[-1])
+        msgEnd = end - 1;
+    else if (']' == end[-1]) {
+        // look for ": <--[" such that no ']' is between it and the end
+        for (const char *r = end - 2; p < r; --r) {
+            if (']' == *r)
+                break;
+
+            if ('[' == *r && r < end - 2 && p + 5 <= r
+                    && hasPrefix(r - 5, end, ": <--["))
+            {
+                msgEnd = r - 5;
+                break;
+            }
+        }
+    }
+
+    if (!msgEnd || msgEnd - p < 2)
+        return nullptr;
+
+    return msgEnd;
+}
+
+/// match ^(?:In file included| +) from 
+static bool matchIncPrefix(const char *beg, const char *end)
+{
+    if (hasPrefix(beg, end, "In file included from "))
+        return true;
+
+    const char *p = beg;
+    while (p != end && ' ' == *p)
+        ++p;
+
+    return (2 <= p - beg)
+        && hasPrefix(p, end, "from ");
+}
+
 EToken Tokenizer::readNext(DefEvent *pEvt)
 {
-    std::string line;
-    if (!std::getline(input_, line))
+    boost::string_view line;
+    if (!input_.getLine(&line))
         return T_NULL;
 
+    return this->classify(pEvt, line);
+}
+
+EToken Tokenizer::classify(DefEvent *pEvt, boost::string_view line)
+{
     if (line.empty())
         return T_EMPTY;
 
     // drop CR at end of the line, coming from GCC in source code snippets
     if ('\r' == line.back())
-        line.pop_back();
+        line.remove_suffix(1U);
 
     lineNo_++;
 
     *pEvt = DefEvent();
-    pEvt->msg = line;
+
+    // classify the line directly in the input buffer, copy only the results
+    const char *const beg = line.data();
+    const char *const end = beg + line.size();
 
     // check for line markers produced by gcc-9.2.1 (a.k.a. sidebar)
-    if (boost::regex_match(pEvt->msg, reSideBar_))
+    if (matchSideBar(beg, end)) {
         //  xxx.c:2:1: note: include '<stdlib.h>' or provide a declaration...
         //    1 | #include <stdio.h>
         //  +++ |+#include <stdlib.h>
         //    2 |
+        pEvt->msg.assign(beg, end);
         return T_SIDEBAR;
+    }
 
-    if (boost::regex_match(line, reMarker_))
+    if (matchMarker(beg, end)) {
+        pEvt->msg.assign(beg, end);
         return T_MARKER;
+    }
 
-    EToken tok;
-    boost::smatch sm;
+    LineLoc loc;
+    if (scanLocation(&loc, beg, end)) {
+        EToken tok = T_NULL;
+        const char *p = loc.rest;
+        const char *evtEnd = scanEvent(p, end);
+        if (evtEnd) {
+            // ^RE_LOCATION: (RE_EVENT): (.*)$
+            tok = T_MSG;
+            pEvt->event = boost::string_view(p, evtEnd - p);
+            pEvt->msg.assign(evtEnd + /* ": " */ 2, end);
+        }
+        else if (const char *msgEnd = scanScopeMsg(p, end)) {
+            // ^RE_LOCATION: ([A-Z].+):RE_TOOL_SUFFIX
+            tok = T_SCOPE;
+            pEvt->event = "scope_hint";
+            pEvt->msg.assign(p, msgEnd);
+        }
 
-    if (boost::regex_match(line, sm, reMsg_)) {
-        tok = T_MSG;
-        pEvt->event = sm[/* evt  */ 4];
-        pEvt->msg   = sm[/* msg  */ 5];
-    }
-    else if (boost::regex_match(line, sm, reScope_)) {
-        tok = T_SCOPE;
-        pEvt->event = "scope_hint";
-        pEvt->msg   = sm[/* msg  */ 4];
+        if (tok) {
+            pEvt->fileName = boost::string_view(beg, loc.fileEnd - beg);
+            pEvt->line   = parseDigits(loc.lineBeg, loc.lineEnd);
+            pEvt->column = parseDigits(loc.colBeg,  loc.colEnd);
+            return tok;
+        }
     }
-    else if (boost::regex_match(line, sm, reInc_)) {
+
+    EToken tok;
+    boost::cmatch sm;
+
+    if (matchIncPrefix(beg, end) && boost::regex_match(beg, end, sm, reInc_)) {
         tok = T_INC;
         pEvt->event = "included_from";
         pEvt->msg   = "Included from here.";
     }
-    else if (boost::regex_match(line, sm, reSmatch_)) {
+    else if (std::memchr(beg, ':', end - beg)
+            && boost::regex_match(beg, end, sm, reSmatch_))
+    {
         tok = T_MSG;
-        pEvt->event = sm[/* evt */ 5];
+        pEvt->event = toSymbol(sm[/* evt */ 5]);
         pEvt->msg   = sm[/* fnc */ 4] + "(): ";
         pEvt->msg  += sm[/* msg */ 6];
     }
-    else if (boost::regex_match(line, sm, reUbsanScope_)) {
+    else if (std::memchr(beg, '#', end - beg)
+            && boost::regex_match(beg, end, sm, reUbsanScope_))
+    {
         tok = T_MSG;
         pEvt->event = "note";
         pEvt->msg   = sm[/* fnc */ 2] + "() at " + sm[/* address */ 1];
     }
-    else
+    else {
+        pEvt->msg.assign(beg, end);
         return T_UNKNOWN;
+    }
 
     // read file name, event, and msg
-    pEvt->fileName    = sm["file"];
+    pEvt->fileName    = toSymbol(sm["file"]);
 
     // parse line number
     pEvt->line = parse_int(sm["line"]);
@@ -383,13 +643,30 @@ EToken MultilineConcatenator::readNext(DefEvent *pEvt)
     return tok;
 }
 
-class BasicGccParser {
+/// source of defects that are not yet merged and post-processed
+class ICoreParser {
+    public:
+        virtual ~ICoreParser() { }
+        virtual bool getNext(Defect *) = 0;
+        virtual bool hasError() const = 0;
+};
+
+static void printSyntaxError(
+        std::ostream               &errStr,
+        const std::string          &fileName,
+        const int                   lineNo)
+{
+    errStr << fileName << ":" << lineNo << ": error: invalid syntax\n";
+}
+
+class BasicGccParser: public ICoreParser {
     public:
         BasicGccParser(InStream &input):
-            rawTokenizer_(input.str()),
+            rawTokenizer_(input),
             noiseFilter_(&rawTokenizer_),
             markerConverter_(&noiseFilter_),
             tokenizer_(&markerConverter_),
+            errStr_(input.errStr()),
             fileName_(input.fileName()),
             silent_(input.silent()),
             hasKeyEvent_(false),
@@ -397,19 +674,31 @@ class BasicGccParser {
         {
         }
 
-        bool getNext(Defect *);
-        bool hasError() const;
+        bool getNext(Defect *) override;
+        bool hasError() const override;
+
+        /// record line numbers of syntax errors instead of printing them
+        void deferErrors(std::vector<int> *pErrLines) {
+            pErrLines_ = pErrLines;
+        }
+
+        /// number of non-empty lines read so far
+        int lineCount() const {
+            return rawTokenizer_.lineNo();
+        }
 
     private:
         Tokenizer               rawTokenizer_;
         NoiseFilter             noiseFilter_;
         MarkerConverter         markerConverter_;
         MultilineConcatenator   tokenizer_;
+        std::ostream           &errStr_;
         const std::string       fileName_;
         const bool              silent_;
         bool                    hasKeyEvent_;
         bool                    hasError_;
         Defect                  defCurrent_;
+        std::vector<int>       *pErrLines_ = nullptr;
 
         void handleError();
         bool digCppcheckEvt(Defect *pDef);
@@ -444,8 +733,10 @@ void BasicGccParser::handleError()
     if (silent_)
         return;
 
-    std::cerr << fileName_ << ":" << tokenizer_.lineNo()
-        << ": error: invalid syntax\n";
+    if (pErrLines_)
+        pErrLines_->push_back(tokenizer_.lineNo());
+    else
+        printSyntaxError(errStr_, fileName_, tokenizer_.lineNo());
 }
 
 bool BasicGccParser::digCppcheckEvt(Defect *pDef)
@@ -461,9 +752,7 @@ bool BasicGccParser::digCppcheckEvt(Defect *pDef)
 
     // format produced by cscppc, embed cppcheck checker's ID into the event
     pDef->checker = "CPPCHECK_WARNING";
-    keyEvt.event += "[";
-    keyEvt.event += sm[/* id  */ 1];
-    keyEvt.event += "]";
+    keyEvt.event = keyEvt.event.str() + "[" + sm[/* id  */ 1].str() + "]";
 
     // store CWE if available
     pDef->cwe = parse_int(sm[/* cwe */ 2]);
@@ -505,7 +794,7 @@ bool BasicGccParser::exportAndReset(Defect *pDef)
             // <--[cppcheck] ... assume cppcheck running with --template=gcc
             def.checker = "CPPCHECK_WARNING";
     }
-    else if (boost::regex_match(keyEvt.event, reProspector_))
+    else if (boost::regex_match(keyEvt.event.str(), reProspector_))
         def.checker = "PROSPECTOR_WARNING";
     else if (boost::regex_match(keyEvt.msg, reShellCheckMsg_))
         def.checker = "SHELLCHECK_WARNING";
@@ -574,6 +863,195 @@ bool BasicGccParser::hasError() const
     return hasError_;
 }
 
+/// parse input mapped into memory by chunks that are processed in parallel
+class ChunkedGccParser: public ICoreParser {
+    public:
+        ChunkedGccParser(InStream &input, boost::string_view data);
+
+        bool getNext(Defect *) override;
+
+        bool hasError() const override {
+            return hasError_;
+        }
+
+        /// inputs smaller than this are not worth splitting into chunks, the
+        /// size can be lowered by the CSDIFF_GCC_CHUNK_SIZE environment
+        /// variable to exercise the chunk boundaries on small inputs in tests
+        static size_t chunkSize();
+
+    private:
+        /// results of parsing a single chunk
+        struct Chunk {
+            std::vector<Defect>         defList;
+            std::vector<int>            errLines;
+            int                         lineCount = 0;
+            bool                        hasError = false;
+        };
+
+        InStream                       &input_;
+        const boost::string_view        data_;
+        size_t                          nextChunkBeg_ = 0U;
+        std::deque<std::future<Chunk>>  pending_;
+        Chunk                           current_;
+        size_t                          nextDef_ = 0U;
+        int                             lineBase_ = 0;
+        bool                            hasError_ = false;
+
+        size_t findResyncPoint(size_t pos) const;
+        void launchChunks();
+        static Chunk parseChunk(const InStream &, boost::string_view);
+};
+
+size_t ChunkedGccParser::chunkSize()
+{
+    static const size_t size = []() -> size_t {
+        const char *env = getenv("CSDIFF_GCC_CHUNK_SIZE");
+        const unsigned long val = (env) ? strtoul(env, nullptr, 0) : 0UL;
+        return (val)
+            ? val
+            : 0x1000000;
+    }();
+
+    return size;
+}
+
+ChunkedGccParser::ChunkedGccParser(InStream &input, boost::string_view data):
+    input_(input),
+    data_(data)
+{
+    this->launchChunks();
+}
+
+/// true if tok can start a chunk when the last non-empty line was a message
+static bool canStartChunk(
+        const EToken                tok,
+        const DefEvent             &evt,
+        const DefEvent             &lastMsg)
+{
+    switch (tok) {
+        case T_INC:
+        case T_SCOPE:
+            return true;
+
+        case T_MSG:
+            break;
+
+        default:
+            return false;
+    }
+
+    if (evt.event == "note")
+        // notes are often continuations of the previous diagnostic
+        return false;
+
+    // MultilineConcatenator may merge messages with the same location
+    return evt.event != lastMsg.event
+        || evt.fileName != lastMsg.fileName
+        || evt.line != lastMsg.line
+        || evt.column != lastMsg.column;
+}
+
+/// Return offset of the first line at or after pos where BasicGccParser can
+/// start parsing with empty state and produce the same results as if it was
+/// parsing the input from the beginning.  That is a line starting a new
+/// diagnostic right after a message line (optionally followed by empty
+/// lines), so the previous defect is complete and the line is not going to
+/// be merged into it by any of the token filters.
+size_t ChunkedGccParser::findResyncPoint(size_t pos) const
+{
+    const size_t size = data_.size();
+    if (size <= pos)
+        return size;
+
+    // start at the beginning of the next line
+    if (pos && '\n' != data_[pos - 1]) {
+        pos = data_.find('\n', pos);
+        if (boost::string_view::npos == pos)
+            return size;
+
+        ++pos;
+    }
+
+    InStream input(data_.substr(pos), input_.fileName(), /* silent */ true);
+    Tokenizer tokenizer(input);
+    boost::string_view line;
+    EToken lastTok = T_NULL;
+    DefEvent lastEvt;
+    while (input.getLine(&line)) {
+        DefEvent evt;
+        const EToken tok = tokenizer.classify(&evt, line);
+        if (T_EMPTY == tok)
+            continue;
+
+        if (T_MSG == lastTok && canStartChunk(tok, evt, lastEvt))
+            return line.data() - data_.data();
+
+        lastTok = tok;
+        lastEvt = std::move(evt);
+    }
+
+    return size;
+}
+
+ChunkedGccParser::Chunk ChunkedGccParser::parseChunk(
+        const InStream             &orig,
+        const boost::string_view    data)
+{
+    InStream input(data, orig.fileName(), orig.silent());
+    BasicGccParser core(input);
+
+    Chunk chunk;
+    core.deferErrors(&chunk.errLines);
+
+    Defect def;
+    while (core.getNext(&def))
+        chunk.defList.push_back(std::move(def));
+
+    chunk.lineCount = core.lineCount();
+    chunk.hasError = core.hasError();
+    return chunk;
+}
+
+void ChunkedGccParser::launchChunks()
+{
+    const size_t size = data_.size();
+    const size_t maxPending = input_.jobs();
+    while (nextChunkBeg_ < size && pending_.size() < maxPending) {
+        const size_t beg = nextChunkBeg_;
+        const size_t end = this->findResyncPoint(beg + chunkSize());
+        pending_.push_back(std::async(std::launch::async, &parseChunk,
+                    std::cref(input_), data_.substr(beg, end - beg)));
+
+        nextChunkBeg_ = end;
+    }
+}
+
+bool ChunkedGccParser::getNext(Defect *pDef)
+{
+    while (current_.defList.size() <= nextDef_) {
+        if (pending_.empty())
+            // all chunks processed
+            return false;
+
+        // wait for the next chunk and keep the other threads busy
+        lineBase_ += current_.lineCount;
+        current_ = pending_.front().get();
+        pending_.pop_front();
+        nextDef_ = 0U;
+        this->launchChunks();
+
+        // report syntax errors with line numbers relative to the whole input
+        for (const int lineNo : current_.errLines)
+            printSyntaxError(input_.errStr(), input_.fileName(),
+                    lineBase_ + lineNo);
+
+        hasError_ |= current_.hasError;
+    }
+
+    *pDef = std::move(current_.defList[nextDef_++]);
+    return true;
+}
+
 } // namespace GccParserImpl
 
 using namespace GccParserImpl;
@@ -619,7 +1097,7 @@ void GccPostProcessor::Private::transGccAnal(Defect *pDef) const
 
     // COMPILER_WARNING -> GCC_ANALYZER_WARNING
     pDef->checker = "GCC_ANALYZER_WARNING";
-    keyEvt.event += sm[/* id */ 2];
+    keyEvt.event = keyEvt.event.str() + sm[/* id */ 2].str();
     // this invalidates sm
     keyEvt.msg = sm[/* msg */ 1];
 
@@ -693,7 +1171,7 @@ void GccPostProcessor::Private::transSuffixGeneric(
         return;
 
     // append [...] to key event ID and remove it from event msg
-    keyEvt.event += sm[/* id */ 2];
+    keyEvt.event = keyEvt.event.str() + sm[/* id */ 2].str();
     // this invalidates sm
     keyEvt.msg = sm[/* msg */ 1];
 }
@@ -714,13 +1192,19 @@ void GccPostProcessor::apply(Defect *pDef) const
 }
 
 struct GccParser::Private {
-    BasicGccParser              core;
+    std::unique_ptr<ICoreParser> core;
     GccPostProcessor            postProc;
     Defect                      lastDef;
 
-    Private(InStream &input):
-        core(input)
+    Private(InStream &input)
     {
+        boost::string_view data;
+        if (1U < input.jobs() && input.mappedData(&data)
+                && ChunkedGccParser::chunkSize() < data.size())
+            // large input mapped into memory -> parse it by chunks in parallel
+            core.reset(new ChunkedGccParser(input, data));
+        else
+            core.reset(new BasicGccParser(input));
     }
 
     bool checkMerge(DefEvent &keyEvt);
@@ -795,12 +1279,12 @@ bool GccParser::getNext(Defect *pDef)
     d->lastDef.events.clear();
     if (pDef->events.size() <= pDef->keyEventIdx
         // no valid last defect --> read a new one
-            && !d->core.getNext(pDef))
+            && !d->core->getNext(pDef))
         // no valid current defect either
         return false;
 
     // defect merging loop
-    while (d->core.getNext(&d->lastDef) && d->tryMerge(pDef))
+    while (d->core->getNext(&d->lastDef) && d->tryMerge(pDef))
         ;
 
     // initialize verbosityLevel 
@@ -819,5 +1303,5 @@ bool GccParser::getNext(Defect *pDef)
 
 bool GccParser::hasError() const
 {
-    return d->core.hasError();
+    return d->core->hasError();
 }
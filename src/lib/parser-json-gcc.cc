@@ -37,9 +37,8 @@ static bool gccReadEvent(DefEvent *pEvt, const pt::ptree &evtNode)
     using std::string;
 
     // read kind (error, warning, note)
-    string &evtName = pEvt->event;
-    evtName = valueOf<string>(evtNode, "kind");
-    if (evtName.empty())
+    pEvt->event = valueOf<string>(evtNode, "kind");
+    if (pEvt->event.empty())
         return false;
 
     // read location
@@ -319,12 +319,12 @@ bool SarifTreeDecoder::readNode(Defect *def)
         boost::smatch sm;
         if (boost::regex_match(rule, sm, d->reRuleId)) {
             // csdiff format
-            def->checker    = sm[/* checker  */ 1];
-            keyEvent.event  = sm[/* keyEvent */ 2];
+            def->checker    = toSymbol(sm[/* checker  */ 1]);
+            keyEvent.event  = toSymbol(sm[/* keyEvent */ 2]);
         }
         else {
             // output of a single tool
-            keyEvent.event += "[" + rule + "]";
+            keyEvent.event = level + "[" + rule + "]";
 
             // distinguish GCC compiler/analyzer
             if (def->checker == "COMPILER_WARNING"
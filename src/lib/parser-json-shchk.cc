@@ -37,9 +37,8 @@ static bool scReadEvent(DefEvent *pEvt, const pt::ptree &evtNode)
     using std::string;
 
     // read level (error, warning, note)
-    string &evtName = pEvt->event;
-    evtName = valueOf<string>(evtNode, "level");
-    if (evtName.empty())
+    pEvt->event = valueOf<string>(evtNode, "level");
+    if (pEvt->event.empty())
         return false;
 
     // read location
@@ -90,7 +90,7 @@ void SimpleTreeDecoder::Private::reportUnknownNodes(
     for (const pt::ptree::value_type &item : node) {
         const std::string &name = item.first;
         if (nodeSet.end() == nodeSet.find(name))
-            std::cerr << this->input.fileName()
+            this->input.errStr() << this->input.fileName()
                 << ": warning: unknown JSON node: " << name
                 << std::endl;
     }
@@ -121,8 +121,12 @@ bool SimpleTreeDecoder::readNode(Defect *def)
         // failed initialization or EOF
         return false;
 
-    const pt::ptree &defNode = *pNode;
+    this->decodeNode(def, *pNode);
+    return true;
+}
 
+void SimpleTreeDecoder::decodeNode(Defect *def, const pt::ptree &defNode)
+{
     d->reportUnknownNodes(Private::NK_DEFECT, defNode);
 
     // the checker field is mandatory
@@ -147,7 +151,7 @@ bool SimpleTreeDecoder::readNode(Defect *def)
         if (-1 == evt.verbosityLevel)
             verbosityLevelNeedsInit = true;
 
-        evtListDst.push_back(evt);
+        evtListDst.push_back(std::move(evt));
     }
 
     // read "defect_id", "cwe", and "function" if available
@@ -179,7 +183,5 @@ bool SimpleTreeDecoder::readNode(Defect *def)
 
     // read annotation if available
     def->annotation = valueOf<std::string>(defNode, "annotation");
-
-    return true;
 }
 
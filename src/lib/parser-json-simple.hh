@@ -35,6 +35,9 @@ class SimpleTreeDecoder: public AbstractTreeDecoder {
 
         bool readNode(Defect *def) override;
 
+        /// decode a single node of the "defects" array into def
+        void decodeNode(Defect *def, const pt::ptree &defNode);
+
     private:
         struct Private;
         std::unique_ptr<Private> d;
@@ -0,0 +1,464 @@
+/*
+ * Copyright (C) 2023 Red Hat, Inc.
+ *
+ * This file is part of csdiff.
+ *
+ * csdiff is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * csdiff is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with csdiff.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "parser-json-stream.hh"
+
+#include <algorithm>
+#include <cctype>
+#include <deque>
+
+#include <boost/json/basic_parser_impl.hpp>
+
+namespace json = boost::json;
+
+/// SAX handler that cuts the native JSON format into separate property trees
+struct JsonStreamHandler {
+    static constexpr std::size_t max_array_size     = -1;
+    static constexpr std::size_t max_object_size    = -1;
+    static constexpr std::size_t max_string_size    = -1;
+    static constexpr std::size_t max_key_size       = -1;
+
+    enum ECapture {
+        CT_NONE,
+        CT_SCAN,
+        CT_DEFECT
+    };
+
+    std::vector<char>           containers;     ///< '{' or '[' per nest level
+    std::string                 key;            ///< the last key read
+    std::string                 rootKey;        ///< the last top-level key
+    std::string                 str;            ///< string/number being read
+    bool                        defectsSeen = false;
+    bool                        foreignSeen = false;    ///< not native JSON
+    bool                        inDefects = false;
+    bool                        defectsDone = false;
+
+    ECapture                    capture = CT_NONE;
+    pt::ptree                   captured;
+    std::vector<pt::ptree *>    nodes;          ///< nodes being constructed
+
+    bool                        haveScan = false;
+    bool                        scanSeen = false;
+    pt::ptree                   scanNode;
+    std::deque<pt::ptree>       defects;
+
+    void beginValue();
+    pt::ptree* appendNode(const pt::ptree &node);
+    void finishCapture();
+
+    bool handleScalar(const std::string &val);
+    bool handleContainerBegin(char kind);
+    bool handleContainerEnd();
+
+    bool on_document_begin(json::error_code &)  { return true; }
+    bool on_document_end(json::error_code &)    { return true; }
+
+    bool on_object_begin(json::error_code &) {
+        return this->handleContainerBegin('{');
+    }
+
+    bool on_object_end(std::size_t, json::error_code &) {
+        return this->handleContainerEnd();
+    }
+
+    bool on_array_begin(json::error_code &) {
+        return this->handleContainerBegin('[');
+    }
+
+    bool on_array_end(std::size_t, json::error_code &) {
+        return this->handleContainerEnd();
+    }
+
+    bool on_key_part(json::string_view s, std::size_t, json::error_code &) {
+        key.append(s.data(), s.size());
+        return true;
+    }
+
+    bool on_key(json::string_view s, std::size_t, json::error_code &) {
+        key.append(s.data(), s.size());
+        if (1U == containers.size()) {
+            rootKey = key;
+            if (rootKey == "defects")
+                defectsSeen = true;
+            else if (rootKey != "scan")
+                // only "scan" may precede "defects" in the native format
+                foreignSeen = true;
+        }
+
+        return true;
+    }
+
+    bool on_string_part(json::string_view s, std::size_t, json::error_code &) {
+        str.append(s.data(), s.size());
+        return true;
+    }
+
+    bool on_string(json::string_view s, std::size_t, json::error_code &) {
+        str.append(s.data(), s.size());
+        return this->handleScalar(str);
+    }
+
+    bool on_number_part(json::string_view s, json::error_code &) {
+        str.append(s.data(), s.size());
+        return true;
+    }
+
+    // numbers are kept in their textual form, as property_tree does
+    bool on_int64(int64_t, json::string_view s, json::error_code &) {
+        str.append(s.data(), s.size());
+        return this->handleScalar(str);
+    }
+
+    bool on_uint64(uint64_t, json::string_view s, json::error_code &) {
+        str.append(s.data(), s.size());
+        return this->handleScalar(str);
+    }
+
+    bool on_double(double, json::string_view s, json::error_code &) {
+        str.append(s.data(), s.size());
+        return this->handleScalar(str);
+    }
+
+    bool on_bool(bool b, json::error_code &) {
+        return this->handleScalar((b) ? "true" : "false");
+    }
+
+    bool on_null(json::error_code &) {
+        return this->handleScalar("null");
+    }
+
+    bool on_comment_part(json::string_view, json::error_code &) {
+        return true;
+    }
+
+    bool on_comment(json::string_view, json::error_code &) {
+        return true;
+    }
+};
+
+/// start capturing if a value of interest begins
+void JsonStreamHandler::beginValue()
+{
+    if (CT_NONE != capture)
+        // already capturing
+        return;
+
+    switch (containers.size()) {
+        case 1U:
+            if ('{' == containers.front() && rootKey == "scan")
+                capture = CT_SCAN;
+            break;
+
+        case 2U:
+            if (inDefects)
+                capture = CT_DEFECT;
+            break;
+
+        default:
+            break;
+    }
+}
+
+/// append a node to the tree being captured and return pointer to it
+pt::ptree* JsonStreamHandler::appendNode(const pt::ptree &node)
+{
+    if (nodes.empty()) {
+        // root node of the captured tree
+        captured = node;
+        return &captured;
+    }
+
+    // items of JSON arrays are stored with empty keys in property trees
+    const std::string nodeKey = ('{' == containers.back())
+        ? key
+        : std::string();
+
+    pt::ptree *parent = nodes.back();
+    return &parent->push_back(std::make_pair(nodeKey, node))->second;
+}
+
+void JsonStreamHandler::finishCapture()
+{
+    if (CT_SCAN == capture) {
+        scanNode.swap(captured);
+        haveScan = true;
+        scanSeen = true;
+    }
+    else {
+        defects.emplace_back();
+        defects.back().swap(captured);
+    }
+
+    captured.clear();
+    captured.data().clear();
+    capture = CT_NONE;
+}
+
+bool JsonStreamHandler::handleScalar(const std::string &val)
+{
+    if (containers.empty())
+        // the native format has an object at the top level
+        foreignSeen = true;
+
+    this->beginValue();
+    if (CT_NONE != capture) {
+        this->appendNode(pt::ptree(val));
+        if (nodes.empty())
+            this->finishCapture();
+    }
+
+    key.clear();
+    str.clear();
+    return true;
+}
+
+bool JsonStreamHandler::handleContainerBegin(const char kind)
+{
+    if (containers.empty() && '{' != kind)
+        // the native format has an object at the top level
+        foreignSeen = true;
+
+    if (1U == containers.size() && '{' == containers.front()
+            && rootKey == "defects" && !inDefects && !defectsDone)
+        // the first container at the "defects" top-level key
+        inDefects = true;
+
+    this->beginValue();
+    if (CT_NONE != capture)
+        nodes.push_back(this->appendNode(pt::ptree()));
+
+    key.clear();
+    containers.push_back(kind);
+    return true;
+}
+
+bool JsonStreamHandler::handleContainerEnd()
+{
+    containers.pop_back();
+    if (CT_NONE != capture) {
+        nodes.pop_back();
+        if (nodes.empty())
+            this->finishCapture();
+    }
+    else if (1U == containers.size() && inDefects) {
+        // end of the "defects" array, ignore any other array of this name
+        inDefects = false;
+        defectsDone = true;
+    }
+
+    return true;
+}
+
+/// stream buffer that replays the given data, followed by the given stream
+class ReplayStreamBuf: public std::streambuf {
+    public:
+        ReplayStreamBuf(std::string data, std::streambuf *rest):
+            data_(std::move(data)),
+            rest_(rest)
+        {
+        }
+
+    protected:
+        int_type underflow() override {
+            if (!dataDone_ && !data_.empty()) {
+                dataDone_ = true;
+                char *beg = &data_[0];
+                this->setg(beg, beg, beg + data_.size());
+            }
+            else {
+                const std::streamsize n = rest_->sgetn(buf_, sizeof buf_);
+                if (n <= 0)
+                    return traits_type::eof();
+
+                this->setg(buf_, buf_, buf_ + n);
+            }
+
+            return traits_type::to_int_type(*this->gptr());
+        }
+
+    private:
+        std::string                 data_;
+        bool                        dataDone_ = false;
+        std::streambuf             *rest_;
+        char                        buf_[0x1000];
+};
+
+static json::parse_options streamParseOpts()
+{
+    json::parse_options opts;
+
+    // property_tree does not limit the nesting depth
+    opts.max_depth = 0x1000;
+
+    // property_tree does not validate UTF-8 sequences
+    opts.allow_invalid_utf8 = true;
+
+    return opts;
+}
+
+struct JsonStreamReader::Private {
+    using TParser = json::basic_parser<JsonStreamHandler>;
+
+    InStream                       &input;
+    TParser                         parser;
+    bool                            done = false;
+    bool                            failed = false;
+    bool                            keepRawData = true;
+    std::string                     rawData;
+    unsigned long                   lineNo = 1UL;
+    char                            buf[0x4000];
+
+    std::unique_ptr<ReplayStreamBuf> replayBuf;
+    std::unique_ptr<std::istream>   replayStr;
+
+    Private(InStream &input_):
+        input(input_),
+        parser(streamParseOpts())
+    {
+    }
+
+    bool readChunk();
+    void handleError(const std::string &msg);
+};
+
+void JsonStreamReader::Private::handleError(const std::string &msg)
+{
+    this->done = true;
+    this->failed = true;
+    if (this->keepRawData)
+        // the input is going to be parsed again in the fallback mode
+        return;
+
+    this->input.handleError(msg, this->lineNo);
+}
+
+/// feed one chunk of the input to the parser, return false if done
+bool JsonStreamReader::Private::readChunk()
+{
+    if (this->done)
+        return false;
+
+    std::istream &str = this->input.str();
+    str.read(this->buf, sizeof this->buf);
+    const size_t len = str.gcount();
+    const bool more = !!str;
+    if (this->keepRawData)
+        this->rawData.append(this->buf, len);
+
+    json::error_code ec;
+    const size_t cnt = this->parser.write_some(more, this->buf, len, ec);
+    this->lineNo += std::count(this->buf, this->buf + cnt, '\n');
+    if (ec) {
+        this->handleError(ec.message());
+        return false;
+    }
+
+    if (!this->parser.done())
+        // more data needed
+        return true;
+
+    // the JSON document is complete, only white-spaces may follow
+    this->done = true;
+    bool garbage = std::any_of(this->buf + cnt, this->buf + len, [](char c) {
+            return !isspace(static_cast<unsigned char>(c));
+    });
+
+    for (int c; !garbage && more && EOF != (c = str.get());)
+        garbage = !isspace(c);
+
+    if (garbage) {
+        this->handleError("garbage after data");
+        return false;
+    }
+
+    return true;
+}
+
+JsonStreamReader::JsonStreamReader(InStream &input):
+    d(new Private(input))
+{
+}
+
+JsonStreamReader::~JsonStreamReader() = default;
+
+bool JsonStreamReader::readHead()
+{
+    // decide by the top-level keys read so far so that other JSON formats
+    // are not parsed twice as a whole and only the first chunks are replayed
+    const JsonStreamHandler &handler = d->parser.handler();
+    while (!handler.defectsSeen) {
+        if (handler.foreignSeen)
+            // not the native JSON format
+            return false;
+
+        if (!d->readChunk())
+            // not the native JSON format or a parse error
+            return false;
+    }
+
+    if (d->failed)
+        // let the fallback report the error
+        return false;
+
+    // we are not going to fall back --> no need to keep the raw data
+    d->keepRawData = false;
+    std::string().swap(d->rawData);
+    return true;
+}
+
+std::istream& JsonStreamReader::replayStream()
+{
+    if (!d->replayStr) {
+        std::streambuf *rest = d->input.str().rdbuf();
+        d->replayBuf.reset(new ReplayStreamBuf(std::move(d->rawData), rest));
+        d->replayStr.reset(new std::istream(d->replayBuf.get()));
+    }
+
+    return *d->replayStr;
+}
+
+bool JsonStreamReader::readNextDefect(pt::ptree *pDst)
+{
+    std::deque<pt::ptree> &defects = d->parser.handler().defects;
+    while (defects.empty())
+        if (!d->readChunk() && defects.empty())
+            // EOF or error
+            return false;
+
+    pDst->swap(defects.front());
+    defects.pop_front();
+    return true;
+}
+
+bool JsonStreamReader::takeScanNode(pt::ptree *pDst)
+{
+    JsonStreamHandler &handler = d->parser.handler();
+    if (!handler.haveScan)
+        return false;
+
+    pDst->swap(handler.scanNode);
+    handler.haveScan = false;
+    return true;
+}
+
+bool JsonStreamReader::scanNodeFinal() const
+{
+    return d->parser.handler().scanSeen
+        || d->done;
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2023 Red Hat, Inc.
+ *
+ * This file is part of csdiff.
+ *
+ * csdiff is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * csdiff is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with csdiff.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef H_GUARD_PARSER_JSON_STREAM_H
+#define H_GUARD_PARSER_JSON_STREAM_H
+
+#include "abstract-tree.hh"
+
+/// incremental reader of the native JSON format of csdiff
+///
+/// Only the "scan" node and one item of the "defects" array at a time are
+/// kept in memory, each of them as a separate property tree.
+class JsonStreamReader {
+    public:
+        JsonStreamReader(InStream &input);
+        ~JsonStreamReader();
+
+        /// read the input up to the "defects" array
+        ///
+        /// @return false if the input is not in the native JSON format (or
+        /// could not be parsed), in which case the input can be read again
+        /// from the beginning via replayStream()
+        bool readHead();
+
+        /// stream replaying the already consumed data, followed by the rest
+        std::istream& replayStream();
+
+        /// read the next item of the "defects" array, false on EOF or error
+        bool readNextDefect(pt::ptree *pDst);
+
+        /// move the "scan" node to pDst if it has been read and not yet taken
+        bool takeScanNode(pt::ptree *pDst);
+
+        /// true if the "scan" node has been read or the input is exhausted
+        bool scanNodeFinal() const;
+
+    private:
+        struct Private;
+        std::unique_ptr<Private> d;
+};
+
+#endif /* H_GUARD_PARSER_JSON_STREAM_H */
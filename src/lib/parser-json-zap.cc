@@ -90,7 +90,7 @@ void ZapTreeDecoder::Private::readAlertProto(const pt::ptree &alertNode)
     // read "alertRef" if available
     const auto alertRef = valueOf<std::string>(alertNode, "alertRef");
     if (!alertRef.empty())
-        evt.event += "[" + alertRef + "]";
+        evt.event = evt.event.str() + "[" + alertRef + "]";
 
     // read "alert" if available
     evt.msg = valueOf<std::string>(alertNode, "alert");
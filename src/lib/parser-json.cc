@@ -24,12 +24,14 @@
 #include "parser-json-sarif.hh"
 #include "parser-json-shchk.hh"
 #include "parser-json-simple.hh"
+#include "parser-json-stream.hh"
 #include "parser-json-zap.hh"
 
 #include <boost/property_tree/json_parser.hpp>
 
 struct JsonParser::Private {
     using TDecoderPtr = std::unique_ptr<AbstractTreeDecoder>;
+    using TReaderPtr = std::unique_ptr<JsonStreamReader>;
 
     InStream                       &input;
     TDecoderPtr                     decoder;
@@ -37,12 +39,18 @@ struct JsonParser::Private {
     int                             defNumber = 0;
     TScanProps                      scanProps;
 
+    // used only while streaming the native JSON format of csdiff
+    TReaderPtr                      reader;
+    std::unique_ptr<SimpleTreeDecoder> streamDecoder;
+
     Private(InStream &input):
         input(input)
     {
     }
 
     void dataError(const std::string &msg);
+    void readStreamedScanProps();
+    bool getNextStreamed(Defect *def);
 };
 
 void JsonParser::Private::dataError(const std::string &msg)
@@ -51,17 +59,63 @@ void JsonParser::Private::dataError(const std::string &msg)
     if (this->input.silent())
         return;
 
-    std::cerr
+    this->input.errStr()
         << this->input.fileName() << ": error: failed to read defect #"
         << this->defNumber << ": " << msg << "\n";
 }
 
+void JsonParser::Private::readStreamedScanProps()
+{
+    pt::ptree scanNode;
+    if (!this->reader->takeScanNode(&scanNode))
+        return;
+
+    pt::ptree root;
+    root.put_child("scan", scanNode);
+    this->streamDecoder->readScanProps(&this->scanProps, &root);
+}
+
+bool JsonParser::Private::getNextStreamed(Defect *def)
+{
+    pt::ptree defNode;
+
+    // error recovery loop
+    for (;;) {
+        if (!this->reader->readNextDefect(&defNode)) {
+            // EOF (or error), the "scan" node might follow the "defects" array
+            this->readStreamedScanProps();
+            return false;
+        }
+
+        try {
+            // make sure the Defect structure is properly initialized
+            (*def) = Defect();
+
+            this->streamDecoder->decodeNode(def, defNode);
+            this->defNumber++;
+            return true;
+        }
+        catch (pt::ptree_error &e) {
+            this->dataError(e.what());
+        }
+    }
+}
+
 JsonParser::JsonParser(InStream &input):
     d(new Private(input))
 {
     try {
-        // parse JSON
-        read_json(input.str(), d->root);
+        // read the native JSON format of csdiff one defect at a time
+        d->reader.reset(new JsonStreamReader(input));
+        if (d->reader->readHead()) {
+            d->streamDecoder.reset(new SimpleTreeDecoder(d->input));
+            d->readStreamedScanProps();
+            return;
+        }
+
+        // parse the whole JSON document
+        const Private::TReaderPtr reader(std::move(d->reader));
+        read_json(reader->replayStream(), d->root);
 
         pt::ptree::const_iterator itFirst = d->root.begin();
         if (itFirst == d->root.end())
@@ -119,8 +173,18 @@ const TScanProps& JsonParser::getScanProps() const
     return d->scanProps;
 }
 
+bool JsonParser::scanPropsFinal() const
+{
+    // the "scan" node may follow the "defects" array in the native format
+    return !d->reader
+        || d->reader->scanNodeFinal();
+}
+
 bool JsonParser::getNext(Defect *def)
 {
+    if (d->reader)
+        return d->getNextStreamed(def);
+
     if (!d->decoder)
         // no decoder --> no data to read
         return false;
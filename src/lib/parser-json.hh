@@ -30,6 +30,7 @@ class JsonParser: public AbstractParser {
         bool getNext(Defect *) override;
         bool hasError() const override;
         const TScanProps& getScanProps() const override;
+        bool scanPropsFinal() const override;
 
         EFileFormat inputFormat() const override {
             return FF_JSON;
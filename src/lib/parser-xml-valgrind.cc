@@ -194,7 +194,7 @@ void readStack(Defect *pDef, const pt::ptree &stackNode)
             noteEvt.fileName = getStringValue(*fileNode);
             const std::string dir = valueOf<std::string>(frameNode, "dir");
             if (!dir.empty())
-                noteEvt.fileName = dir + "/" + noteEvt.fileName;
+                noteEvt.fileName = dir + "/" + noteEvt.fileName.str();
 
             // read line number
             noteEvt.line = valueOf<int>(frameNode, "line");
@@ -262,7 +262,7 @@ bool ValgrindTreeDecoder::readNode(Defect *pDef)
     // read "kind" of the report
     const std::string kind = valueOf<std::string>(defNode, "kind");
     if (!kind.empty())
-        keyEvent.event += "[" + kind + "]";
+        keyEvent.event = keyEvent.event.str() + "[" + kind + "]";
 
     // go through stack trace
     const pt::ptree *stackNode;
@@ -19,6 +19,8 @@
 
 #include "parser.hh"
 
+#include "binary-format.hh"
+#include "parser-binary.hh"
 #include "parser-cov.hh"
 #include "parser-gcc.hh"
 #include "parser-json.hh"
@@ -37,6 +39,12 @@ AbstractParserPtr createParser(InStream &input)
     InStreamLookAhead head(input, 2U, /* skipWhiteSpaces */ true);
 
     switch (head[0]) {
+        case BinaryFormat::magic[0]:
+            if (BinaryFormat::magic[1] != head[1])
+                break;
+            // binary format
+            return make_unique<BinaryParser>(input);
+
         case '{':
         case '[':
             // JSON
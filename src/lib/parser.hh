@@ -35,7 +35,8 @@ enum EFileFormat {
     FF_GCC,                                 ///< GCC format
     FF_JSON,                                ///< JSON format
     FF_HTML,                                ///< HTML format (output only)
-    FF_SARIF                                ///< SARIF format (used by GitHub)
+    FF_SARIF,                               ///< SARIF format (used by GitHub)
+    FF_BINARY                               ///< compact binary format
 };
 
 // abstract class with a factory method
@@ -45,11 +46,26 @@ class AbstractParser {
         virtual bool getNext(Defect *) = 0;
         virtual bool hasError() const = 0;
 
+        /// read up to cnt defects to defs[0], defs[1], ... and return the count
+        /// of defects read, zero means the end of input
+        virtual size_t getNextBatch(Defect *defs, const size_t cnt) {
+            size_t i = 0U;
+            while (i < cnt && this->getNext(&defs[i]))
+                ++i;
+
+            return i;
+        }
+
         /// used only by the JSON format
         virtual const TScanProps& getScanProps() const {
             return emptyProps_;
         }
 
+        /// false if scan properties may still follow the defects not yet read
+        virtual bool scanPropsFinal() const {
+            return true;
+        }
+
         virtual EFileFormat inputFormat() const {
             return FF_INVALID;
         }
@@ -74,6 +90,13 @@ class Parser {
         {
         }
 
+        /// use the given parser instead of detecting the input format
+        Parser(InStream &input, AbstractParserPtr &&parser):
+            input_(input),
+            parser_(std::move(parser))
+        {
+        }
+
         // copy constructor and copy assigment operator are implicitly deleted
         // as std::unique_ptr cannot be copied
 
@@ -87,6 +110,10 @@ class Parser {
             return parser_->getNext(def);
         }
 
+        size_t getNextBatch(Defect *defs, const size_t cnt) {
+            return parser_->getNextBatch(defs, cnt);
+        }
+
         bool hasError() const {
             return parser_->hasError();
         }
@@ -95,6 +122,10 @@ class Parser {
             return parser_->getScanProps();
         }
 
+        bool scanPropsFinal() const {
+            return parser_->scanPropsFinal();
+        }
+
         EFileFormat inputFormat() const {
             return parser_->inputFormat();
         };
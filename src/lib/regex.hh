@@ -20,8 +20,30 @@
 #ifndef H_GUARD_REGEX_H
 #define H_GUARD_REGEX_H
 
+#include "symbol.hh"
+
 #include <boost/regex.hpp>
 
 typedef boost::regex RE;
 
+/// intern the matched sub-expression without copying it to a std::string
+template <class TIter>
+inline Symbol toSymbol(const boost::sub_match<TIter> &sm)
+{
+    if (!sm.length())
+        return Symbol();
+
+    return Symbol(boost::string_view(&*sm.first, sm.length()));
+}
+
+/// assign the matched sub-expression to *pDst reusing its memory
+template <class TIter>
+inline void assignSubMatch(std::string *pDst, const boost::sub_match<TIter> &sm)
+{
+    if (sm.matched)
+        pDst->assign(sm.first, sm.second);
+    else
+        pDst->clear();
+}
+
 #endif /* H_GUARD_REGEX_H */
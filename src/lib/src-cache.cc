@@ -0,0 +1,267 @@
+/*
+ * Copyright (C) 2023 Red Hat, Inc.
+ *
+ * This file is part of csdiff.
+ *
+ * csdiff is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * csdiff is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with csdiff.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src-cache.hh"
+
+#include <cerrno>
+#include <cstring>
+#include <list>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/// a single source file loaded into memory
+class SrcFile {
+    public:
+        SrcFile() = default;
+        SrcFile(const SrcFile &) = delete;
+        SrcFile& operator=(const SrcFile &) = delete;
+
+        ~SrcFile() {
+            if (map_)
+                munmap(map_, size_);
+        }
+
+        /// return false if the file could not be opened
+        bool load(const std::string &fileName);
+
+        bool ok() const {
+            return ok_;
+        }
+
+        int lineCount() const {
+            return lineBeg_.size();
+        }
+
+        bool getLine(boost::string_view *pDst, int line) const;
+
+        /// memory occupied by the file and its index in bytes
+        size_t memSize() const {
+            return size_ + lineBeg_.size() * sizeof(size_t);
+        }
+
+    private:
+        char                       *map_ = nullptr;
+        const char                 *data_ = nullptr;
+        size_t                      size_ = 0U;
+        std::string                 buf_;
+        std::vector<size_t>         lineBeg_;
+        bool                        ok_ = false;
+
+        void readAll(int fd);
+        void indexLines();
+};
+
+bool SrcFile::load(const std::string &fileName)
+{
+    const int fd = open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (!fstat(fd, &st) && S_ISREG(st.st_mode) && 0 < st.st_size) {
+        // regular file -> map the whole file into memory
+        void *addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (MAP_FAILED != addr) {
+            map_ = static_cast<char *>(addr);
+            data_ = map_;
+            size_ = st.st_size;
+        }
+    }
+
+    if (!map_)
+        // special or empty file, or mmap() failed -> read it into memory
+        this->readAll(fd);
+
+    close(fd);
+    this->indexLines();
+    ok_ = true;
+    return true;
+}
+
+void SrcFile::readAll(const int fd)
+{
+    char buf[0x10000];
+    for (;;) {
+        const ssize_t len = read(fd, buf, sizeof buf);
+        if (0 < len)
+            buf_.append(buf, len);
+        else if (len < 0 && EINTR == errno)
+            continue;
+        else
+            // EOF or a read error, such as EISDIR
+            break;
+    }
+
+    data_ = buf_.data();
+    size_ = buf_.size();
+}
+
+/// record the offsets where lines start, same line splitting as std::getline()
+void SrcFile::indexLines()
+{
+    const char *const beg = data_;
+    const char *const end = data_ + size_;
+    for (const char *p = beg; p < end;) {
+        lineBeg_.push_back(p - beg);
+        const void *nl = memchr(p, '\n', end - p);
+        if (!nl)
+            break;
+
+        p = static_cast<const char *>(nl) + 1;
+    }
+}
+
+bool SrcFile::getLine(boost::string_view *pDst, const int line) const
+{
+    const size_t cnt = lineBeg_.size();
+    if (line < 1 || cnt < static_cast<size_t>(line))
+        return false;
+
+    const size_t idx = line - 1;
+    const size_t beg = lineBeg_[idx];
+    size_t end;
+    if (idx + 1U < cnt)
+        end = lineBeg_[idx + 1U] - /* '\n' */ 1U;
+    else {
+        // the last line may or may not be terminated by '\n'
+        end = size_;
+        if (beg < end && '\n' == data_[end - 1U])
+            --end;
+    }
+
+    *pDst = boost::string_view(data_ + beg, end - beg);
+    return true;
+}
+
+
+// /////////////////////////////////////////////////////////////////////////////
+// implementation of SrcFileCache
+
+SrcFileCache* SrcFileCache::self_;
+
+struct SrcFileCache::Private {
+    // names of the loaded files, the most recently used first
+    using TLru = std::list<std::string>;
+
+    struct Entry {
+        SrcFile             file;
+        TLru::iterator      lruPos;
+    };
+
+    using TMap = std::unordered_map<std::string, Entry>;
+
+    TMap                    files;
+    TLru                    lru;
+    size_t                  totalSize = 0U;
+    size_t                  maxSize = 0x10000000;
+    CacheStats              stats{};
+
+    // the most recently used file, which is never unloaded
+    const std::string      *lastName = nullptr;
+    const SrcFile          *lastFile = nullptr;
+
+    const SrcFile& lookup(const std::string &fileName);
+    void evict();
+};
+
+const SrcFile& SrcFileCache::Private::lookup(const std::string &fileName)
+{
+    if (lastName && *lastName == fileName) {
+        // the same file as last time
+        ++stats.hits;
+        return *lastFile;
+    }
+
+    TMap::iterator it = files.find(fileName);
+    if (files.end() != it) {
+        // move the file to the front of the LRU list
+        ++stats.hits;
+        lru.splice(lru.begin(), lru, it->second.lruPos);
+    }
+    else {
+        ++stats.misses;
+        it = files.emplace(std::piecewise_construct,
+                std::forward_as_tuple(fileName),
+                std::forward_as_tuple()).first;
+
+        Entry &ent = it->second;
+        ent.file.load(fileName);
+        ent.lruPos = lru.insert(lru.begin(), fileName);
+        totalSize += ent.file.memSize();
+    }
+
+    lastName = &it->first;
+    lastFile = &it->second.file;
+    this->evict();
+    return *lastFile;
+}
+
+/// unload the least recently used files to stay within the size limit
+void SrcFileCache::Private::evict()
+{
+    while (maxSize < totalSize && 1U < lru.size()) {
+        const TMap::iterator it = files.find(lru.back());
+        totalSize -= it->second.file.memSize();
+        files.erase(it);
+        lru.pop_back();
+        ++stats.evictions;
+    }
+}
+
+SrcFileCache::SrcFileCache():
+    d(new Private)
+{
+}
+
+SrcFileCache::~SrcFileCache() = default;
+
+int SrcFileCache::lineCount(const std::string &fileName)
+{
+    const SrcFile &file = d->lookup(fileName);
+    if (!file.ok())
+        return -1;
+
+    return file.lineCount();
+}
+
+bool SrcFileCache::getLine(
+        boost::string_view         *pDst,
+        const std::string          &fileName,
+        const int                   line)
+{
+    const SrcFile &file = d->lookup(fileName);
+    return file.getLine(pDst, line);
+}
+
+void SrcFileCache::setMaxSize(const size_t maxSize)
+{
+    d->maxSize = maxSize;
+    d->evict();
+}
+
+SrcFileCache::CacheStats SrcFileCache::cacheStats() const
+{
+    return d->stats;
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2023 Red Hat, Inc.
+ *
+ * This file is part of csdiff.
+ *
+ * csdiff is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * csdiff is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with csdiff.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef H_GUARD_SRC_CACHE_H
+#define H_GUARD_SRC_CACHE_H
+
+#include <memory>
+#include <string>
+
+#include <boost/utility/string_view.hpp>
+
+/// source files mapped into memory with an index of line offsets, so that any
+/// line of an already loaded file can be fetched in O(1) time
+///
+/// The least recently used files are unloaded once the total size of loaded
+/// files exceeds the limit.  The class is not thread-safe.
+class SrcFileCache {
+    public:
+        // singleton
+        static SrcFileCache& inst() {
+            return (self_)
+                ? *(self_)
+                : *(self_ = new SrcFileCache);
+        }
+
+        /// return the count of lines in the file, or -1 if it cannot be read
+        int lineCount(const std::string &fileName);
+
+        /// store the line (numbered from 1, without the trailing newline) to
+        /// *pDst and return true, or return false if there is no such line
+        ///
+        /// The view is valid until a different file is requested.
+        bool getLine(
+                boost::string_view         *pDst,
+                const std::string          &fileName,
+                int                         line);
+
+        /// limit for the total size of the loaded files in bytes
+        void setMaxSize(size_t);
+
+        /// counters of file lookups served from the cache (hits), file loads
+        /// (misses), and files unloaded to stay within the size limit
+        struct CacheStats {
+            unsigned long   hits;
+            unsigned long   misses;
+            unsigned long   evictions;
+        };
+
+        CacheStats cacheStats() const;
+
+    private:
+        SrcFileCache();
+        ~SrcFileCache();
+
+        static SrcFileCache *self_;
+        struct Private;
+        std::unique_ptr<Private> d;
+};
+
+#endif /* H_GUARD_SRC_CACHE_H */
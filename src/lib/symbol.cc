@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2023 Red Hat, Inc.
+ *
+ * This file is part of csdiff.
+ *
+ * csdiff is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * csdiff is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with csdiff.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "symbol.hh"
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+const std::string Symbol::emptyStr_;
+
+/// 64-bit FNV-1a hash of str
+static size_t hashStr(const boost::string_view str)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (const unsigned char c : str) {
+        hash ^= c;
+        hash *= 0x100000001b3ULL;
+    }
+
+    return hash;
+}
+
+struct StrViewHash {
+    size_t operator()(const boost::string_view str) const {
+        return hashStr(str);
+    }
+};
+
+/// a part of the symbol table guarded by its own lock to reduce contention
+struct SymbolShard {
+    std::mutex                                  lock;
+
+    /// the keys refer to the strings stored in entries
+    std::unordered_map<boost::string_view, const Symbol::Entry *, StrViewHash>
+                                                lookup;
+
+    /// std::deque does not move its elements when growing
+    std::deque<Symbol::Entry>                   entries;
+};
+
+static const unsigned shardCount = 16U;
+
+/// size of the per-thread cache of recently used symbols
+static const unsigned cacheSize = 256U;
+
+const Symbol::Entry* Symbol::intern(const boost::string_view str)
+{
+    if (str.empty())
+        return nullptr;
+
+    // intentionally leaked so that symbols stay valid in static destructors
+    static SymbolShard *const shards = new SymbolShard[shardCount];
+
+    const size_t hash = hashStr(str);
+
+    // most lookups hit a few hot strings, try them without locking first
+    static thread_local const Entry *cache[cacheSize];
+    const Entry *&cached = cache[hash % cacheSize];
+    if (cached && cached->hash == hash && cached->str == str)
+        return cached;
+
+    SymbolShard &shard = shards[(hash >> 32) % shardCount];
+    std::lock_guard<std::mutex> guard(shard.lock);
+
+    const auto it = shard.lookup.find(str);
+    if (shard.lookup.end() != it)
+        return (cached = it->second);
+
+    shard.entries.push_back(Entry{std::string(str.data(), str.size()), hash});
+    const Entry *ent = &shard.entries.back();
+    shard.lookup.emplace(ent->str, ent);
+    return (cached = ent);
+}
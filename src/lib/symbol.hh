@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2023 Red Hat, Inc.
+ *
+ * This file is part of csdiff.
+ *
+ * csdiff is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * csdiff is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with csdiff.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef H_GUARD_SYMBOL_H
+#define H_GUARD_SYMBOL_H
+
+#include <cstring>
+#include <functional>
+#include <ostream>
+#include <string>
+
+#include <boost/utility/string_view.hpp>
+
+/// immutable string interned in a process-wide symbol table
+///
+/// Symbols with the same contents share a single copy of the string, so they
+/// can be copied, compared for equality, and hashed in constant time.  The
+/// interned strings are never released.  Interning is thread-safe.
+class Symbol {
+    public:
+        /// the empty string, no need to look it up in the symbol table
+        Symbol() = default;
+
+        Symbol(boost::string_view str):
+            ent_(intern(str))
+        {
+        }
+
+        Symbol(const std::string &str):
+            ent_(intern(str))
+        {
+        }
+
+        Symbol(const char *str):
+            ent_(intern(str))
+        {
+        }
+
+        const std::string& str() const {
+            return (ent_) ? ent_->str : emptyStr_;
+        }
+
+        /// for code that expects a plain std::string
+        operator const std::string&() const {
+            return this->str();
+        }
+
+        const char* c_str() const {
+            return this->str().c_str();
+        }
+
+        bool empty() const {
+            return !ent_;
+        }
+
+        size_t size() const {
+            return this->str().size();
+        }
+
+        /// hash of the string, computed once while interning it
+        size_t hash() const {
+            return (ent_) ? ent_->hash : 0U;
+        }
+
+        /// true if both symbols hold the same string
+        bool operator==(const Symbol &other) const {
+            return ent_ == other.ent_;
+        }
+
+        bool operator!=(const Symbol &other) const {
+            return ent_ != other.ent_;
+        }
+
+        /// order symbols by their contents to keep the output stable
+        bool operator<(const Symbol &other) const {
+            return (ent_ != other.ent_)
+                && this->str() < other.str();
+        }
+
+        struct Entry {
+            const std::string       str;
+            const size_t            hash;
+        };
+
+    private:
+        const Entry                *ent_ = nullptr;
+
+        static const std::string    emptyStr_;
+        static const Entry* intern(boost::string_view);
+};
+
+// compare symbols with plain strings without interning them
+
+inline bool operator==(const Symbol &sym, const std::string &str)
+{
+    return sym.str() == str;
+}
+
+inline bool operator==(const std::string &str, const Symbol &sym)
+{
+    return sym.str() == str;
+}
+
+inline bool operator==(const Symbol &sym, const char *str)
+{
+    return !std::strcmp(sym.c_str(), str);
+}
+
+inline bool operator==(const char *str, const Symbol &sym)
+{
+    return !std::strcmp(sym.c_str(), str);
+}
+
+inline bool operator!=(const Symbol &sym, const std::string &str)
+{
+    return !(sym == str);
+}
+
+inline bool operator!=(const std::string &str, const Symbol &sym)
+{
+    return !(sym == str);
+}
+
+inline bool operator!=(const Symbol &sym, const char *str)
+{
+    return !(sym == str);
+}
+
+inline bool operator!=(const char *str, const Symbol &sym)
+{
+    return !(sym == str);
+}
+
+inline std::ostream& operator<<(std::ostream &str, const Symbol &sym)
+{
+    return str << sym.str();
+}
+
+namespace std {
+    template <>
+    struct hash<Symbol> {
+        size_t operator()(const Symbol &sym) const {
+            return sym.hash();
+        }
+    };
+}
+
+#endif /* H_GUARD_SYMBOL_H */
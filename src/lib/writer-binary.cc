@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2023 Red Hat, Inc.
+ *
+ * This file is part of csdiff.
+ *
+ * csdiff is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * csdiff is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with csdiff.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "writer-binary.hh"
+
+#include "binary-format.hh"
+
+#include <unordered_map>
+
+using namespace BinaryFormat;
+
+struct BinaryWriter::Private {
+    std::ostream                           &str;
+    TScanProps                              scanProps;
+    TScanProps                              writtenProps;
+    bool                                    headWritten = false;
+
+    /// indexes of the strings written so far (shifted by one)
+    std::unordered_map<std::string, uint64_t> strTab;
+
+    /// encoded record that has not been written yet
+    std::string                             buf;
+
+    Private(std::ostream &str_):
+        str(str_)
+    {
+    }
+
+    void appendVarInt(uint64_t);
+    void appendInt(const int64_t num) { this->appendVarInt(zigZagEncode(num)); }
+    void appendStr(const std::string &);
+    void appendInlineStr(const std::string &);
+    void appendScanProps(const TScanProps &);
+    void appendEvent(const DefEvent &);
+    void writeHead();
+    void writeBuf();
+};
+
+void BinaryWriter::Private::appendVarInt(uint64_t num)
+{
+    while (0x80U <= num) {
+        buf.push_back(static_cast<char>(0x80U | (num & 0x7FU)));
+        num >>= 7;
+    }
+
+    buf.push_back(static_cast<char>(num));
+}
+
+void BinaryWriter::Private::appendStr(const std::string &s)
+{
+    // look up first, emplace() would allocate a node even for known strings
+    const auto it = strTab.find(s);
+    if (strTab.end() != it) {
+        // already in the string table
+        this->appendVarInt(it->second);
+        return;
+    }
+
+    const uint64_t nextIdx = strTab.size() + 1U;
+    strTab.emplace(s, nextIdx);
+
+    // a new string
+    this->appendVarInt(0U);
+    this->appendVarInt(s.size());
+    buf.append(s);
+}
+
+/// append a string that is not worth deduplicating
+void BinaryWriter::Private::appendInlineStr(const std::string &s)
+{
+    this->appendVarInt(s.size());
+    buf.append(s);
+}
+
+void BinaryWriter::Private::appendScanProps(const TScanProps &props)
+{
+    buf.push_back(TAG_SCAN_PROPS);
+    this->appendVarInt(props.size());
+    for (const auto &item : props) {
+        this->appendStr(item.first);
+        this->appendInlineStr(item.second);
+    }
+
+    writtenProps = props;
+}
+
+void BinaryWriter::Private::appendEvent(const DefEvent &evt)
+{
+    this->appendStr(evt.fileName);
+    this->appendInt(evt.line);
+    this->appendInt(evt.column);
+    this->appendStr(evt.event);
+    this->appendInlineStr(evt.msg);
+    this->appendInt(evt.verbosityLevel);
+}
+
+void BinaryWriter::Private::writeHead()
+{
+    if (headWritten)
+        return;
+
+    buf.append(magic, magicSize);
+    this->appendVarInt(version);
+
+    // write scan properties known at this point so that they are available
+    // to the reader before it starts reading the defects
+    if (!scanProps.empty())
+        this->appendScanProps(scanProps);
+
+    headWritten = true;
+}
+
+void BinaryWriter::Private::writeBuf()
+{
+    str.write(buf.data(), buf.size());
+    buf.clear();
+}
+
+BinaryWriter::BinaryWriter(std::ostream &str):
+    d(new Private(str))
+{
+}
+
+BinaryWriter::~BinaryWriter() = default;
+
+const TScanProps& BinaryWriter::getScanProps() const
+{
+    return d->scanProps;
+}
+
+void BinaryWriter::setScanProps(const TScanProps &scanProps)
+{
+    d->scanProps = scanProps;
+}
+
+void BinaryWriter::handleDef(const Defect &def)
+{
+    d->writeHead();
+
+    d->buf.push_back(TAG_DEFECT);
+    d->appendStr(def.checker);
+    d->appendInlineStr(def.annotation);
+    d->appendInlineStr(def.function);
+    d->appendStr(def.language);
+    d->appendStr(def.tool);
+    d->appendVarInt(def.keyEventIdx);
+    d->appendInt(def.cwe);
+    d->appendInt(def.imp);
+    d->appendInt(def.defectId);
+
+    d->appendVarInt(def.events.size());
+    for (const DefEvent &evt : def.events)
+        d->appendEvent(evt);
+
+    d->writeBuf();
+}
+
+void BinaryWriter::flush()
+{
+    d->writeHead();
+
+    // scan properties set after the first defect was written
+    if (d->scanProps != d->writtenProps)
+        d->appendScanProps(d->scanProps);
+
+    d->buf.push_back(TAG_END);
+    d->writeBuf();
+    d->str.flush();
+}
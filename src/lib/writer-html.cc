@@ -23,6 +23,8 @@
 #include "deflookup.hh"
 #include "regex.hh"
 
+#include <unordered_map>
+
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/format.hpp>
 #include <boost/lexical_cast.hpp>
@@ -311,6 +313,7 @@ struct HtmlWriter::Private {
     unsigned                        defCnt = 0U;
     DefLookup                      *baseLookup = nullptr;
     RE                              checkerIgnRegex;
+    std::unordered_map<std::string, bool> checkerIgnCache;
     std::string                     newDefMsg;
     std::string                     plainTextUrl;
     const CweNameLookup            *cweNames = nullptr;
@@ -369,6 +372,7 @@ void HtmlWriter::setDiffBase(
     assert(baseLookup);
     d->baseLookup = baseLookup;
     d->checkerIgnRegex = checkerIgnRegex;
+    d->checkerIgnCache.clear();
 
     // TODO: merge with already existing metadata stomping on the same keys
     TScanProps::const_iterator it = baseProps.find("cov-compilation-unit-count");
@@ -438,7 +442,14 @@ void HtmlWriter::Private::writeNewDefWarning(const Defect &def)
         // not lookup set
         return;
 
-    if (boost::regex_match(def.checker, this->checkerIgnRegex))
+    // evaluate the regex only once per checker
+    const auto it = this->checkerIgnCache.find(def.checker);
+    const bool ignored = (this->checkerIgnCache.end() == it)
+        ? (this->checkerIgnCache[def.checker] =
+                boost::regex_match(def.checker.str(), this->checkerIgnRegex))
+        : it->second;
+
+    if (ignored)
         // user requested to ignore this checker for lookup
         return;
 
@@ -207,7 +207,7 @@ static void sarifEncodeLoc(object *pLoc, const Defect &def, unsigned idx)
     // file name
     object locPhy = {
         { "artifactLocation", {
-            { "uri", evt.fileName }
+            { "uri", evt.fileName.str() }
         }}
     };
 
@@ -251,7 +251,7 @@ static void sarifEncodeEvt(array *pDst, const Defect &def, unsigned idx)
         // verbosityLevel
         { "nestingLevel", evt.verbosityLevel },
         // event
-        { "kinds", { evt.event } }
+        { "kinds", { evt.event.str() } }
     };
 
     // append the threadFlowLocation object to the destination array
@@ -285,13 +285,13 @@ void SarifTreeEncoder::appendDef(const Defect &def)
     object result;
 
     // checker (FIXME: suboptimal mapping to SARIF)
-    const std::string ruleId = def.checker + ": " + keyEvt.event;
+    const std::string ruleId = def.checker.str() + ": " + keyEvt.event.str();
     result["ruleId"] = ruleId;
 
     if (def.checker == "SHELLCHECK_WARNING") {
         boost::smatch sm;
         static const RE reShellCheckMsg("(\\[)?(SC[0-9]+)(\\])?$");
-        boost::regex_search(keyEvt.event, sm, reShellCheckMsg);
+        boost::regex_search(keyEvt.event.str(), sm, reShellCheckMsg);
 
         // update ShellCheck rule map
         shellCheckMap_[ruleId] = sm[2];
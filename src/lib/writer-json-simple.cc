@@ -23,15 +23,7 @@
 
 using namespace boost::json;
 
-void SimpleTreeEncoder::importScanProps(const TScanProps &scanProps)
-{
-    if (scanProps.empty())
-        return;
-
-    root_["scan"] = jsonSerializeScanProps(scanProps);
-}
-
-void SimpleTreeEncoder::appendDef(const Defect &def)
+object jsonSerializeDefect(const Defect &def)
 {
     // go through events
     array evtList;
@@ -39,13 +31,13 @@ void SimpleTreeEncoder::appendDef(const Defect &def)
         object evtNode;
 
         // describe the location
-        evtNode["file_name"] = evt.fileName;
+        evtNode["file_name"] = evt.fileName.str();
         evtNode["line"] = evt.line;
         if (0 < evt.column)
             evtNode["column"] = evt.column;
 
         // describe the event
-        evtNode["event"] = evt.event;
+        evtNode["event"] = evt.event.str();
         evtNode["message"] = sanitizeUTF8(evt.msg);
         evtNode["verbosity_level"] = evt.verbosityLevel;
 
@@ -55,7 +47,7 @@ void SimpleTreeEncoder::appendDef(const Defect &def)
 
     // create a node for a single defect
     object defNode;
-    defNode["checker"] = def.checker;
+    defNode["checker"] = def.checker.str();
     if (!def.annotation.empty())
         defNode["annotation"] = def.annotation;
 
@@ -75,20 +67,67 @@ void SimpleTreeEncoder::appendDef(const Defect &def)
 
     defNode["key_event_idx"] = def.keyEventIdx;
     defNode["events"] = std::move(evtList);
+    return defNode;
+}
 
-    // create the node representing the list of defects
-    if (!pDefects_)
-        pDefects_ = &root_["defects"].emplace_array();
+// the layout below needs to match jsonPrettyPrint() of the following tree:
+// { "scan": { ... }, "defects": [ { ... }, ... ] }
 
-    // append the node to the list
-    pDefects_->push_back(std::move(defNode));
+static void writeScanNode(std::ostream &str, const TScanProps &scanProps)
+{
+    std::string indent(4, ' ');
+    str << indent << "\"scan\": ";
+    jsonPrettyPrint(str, jsonSerializeScanProps(scanProps), &indent);
 }
 
-void SimpleTreeEncoder::writeTo(std::ostream &str)
+void SimpleStreamEncoder::writeHead(const TScanProps &scanProps)
 {
-    if (!pDefects_)
-        // create an empty "defects" node to keep format detection working
-        pDefects_ = &root_["defects"].emplace_array();
+    if (headWritten_)
+        return;
+
+    str_ << "{\n";
+    if (!scanProps.empty()) {
+        writeScanNode(str_, scanProps);
+        str_ << ",\n";
+    }
+
+    str_ << "    \"defects\": [";
+    headProps_ = scanProps;
+    headWritten_ = true;
+    indent_.assign(8, ' ');
+}
+
+void SimpleStreamEncoder::appendDef(const Defect &def)
+{
+    str_ << (anyDef_ ? ",\n" : "\n") << indent_;
+    jsonPrettyPrint(str_, jsonSerializeDefect(def), &indent_);
+    anyDef_ = true;
+}
+
+void SimpleStreamEncoder::writeTail(const TScanProps &scanProps)
+{
+    // an empty "defects" node is written anyway to keep format detection working
+    this->writeHead(scanProps);
+
+    if (anyDef_)
+        str_ << "\n    ";
+    str_ << "]";
+
+    if (scanProps != headProps_) {
+        // scan properties were changed after we started to write defects
+        if (headProps_.empty()) {
+            str_ << ",\n";
+            writeScanNode(str_, scanProps);
+        }
+        else
+            std::cerr << "warning: scan properties changed after writing "
+                "defects, ignoring the change\n";
+    }
+
+    str_ << "\n}\n";
 
-    jsonPrettyPrint(str, root_);
+    // reset the state in case the encoder is used again
+    headProps_.clear();
+    headWritten_ = false;
+    anyDef_ = false;
 }
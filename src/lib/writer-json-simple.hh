@@ -20,24 +20,42 @@
 #ifndef H_GUARD_WRITER_JSON_SIMPLE_H
 #define H_GUARD_WRITER_JSON_SIMPLE_H
 
-#include "abstract-tree.hh"
+#include "parser.hh"                // for TScanProps
+
+#include <iostream>
 
 #include <boost/json.hpp>
 
-class SimpleTreeEncoder: public AbstractTreeEncoder {
+/// serialize a single defect as a JSON object of the native format
+boost::json::object jsonSerializeDefect(const Defect &);
+
+/// incremental encoder of the native JSON format
+///
+/// Unlike the tree encoders, it writes each defect to the output stream as
+/// soon as it is appended so that memory usage does not depend on the number
+/// of defects.  The output is identical to jsonPrettyPrint() of the whole tree.
+class SimpleStreamEncoder {
     public:
-        /// import supported scan properties
-        void importScanProps(const TScanProps &) override;
+        SimpleStreamEncoder(std::ostream &str):
+            str_(str)
+        {
+        }
+
+        /// write the header with scan properties (if not written already)
+        void writeHead(const TScanProps &);
 
-        /// append single defect
-        void appendDef(const Defect &) override;
+        /// append single defect, writeHead() needs to be called first
+        void appendDef(const Defect &);
 
-        /// write everything to the given output stream
-        void writeTo(std::ostream &) override;
+        /// finish the document, scan properties are written only if changed
+        void writeTail(const TScanProps &);
 
     private:
-        boost::json::object         root_;
-        boost::json::array         *pDefects_ = nullptr;
+        std::ostream               &str_;
+        TScanProps                  headProps_;
+        bool                        headWritten_ = false;
+        bool                        anyDef_ = false;
+        std::string                 indent_;
 };
 
 #endif /* H_GUARD_WRITER_JSON_SIMPLE_H */
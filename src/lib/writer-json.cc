@@ -31,6 +31,7 @@ struct JsonWriter::Private {
     std::queue<Defect>                      defQueue;
     TScanProps                              scanProps;
     std::unique_ptr<AbstractTreeEncoder>    encoder;
+    std::unique_ptr<SimpleStreamEncoder>    streamEncoder;
 
     Private(std::ostream &str_):
         str(str_)
@@ -43,7 +44,8 @@ JsonWriter::JsonWriter(std::ostream &str, const EFileFormat format):
 {
     switch (format) {
         case FF_JSON:
-            d->encoder.reset(new SimpleTreeEncoder);
+            // the native format is written incrementally
+            d->streamEncoder.reset(new SimpleStreamEncoder(str));
             break;
 
         case FF_SARIF:
@@ -67,11 +69,34 @@ void JsonWriter::setScanProps(const TScanProps &scanProps)
 
 void JsonWriter::handleDef(const Defect &def)
 {
+    if (d->streamEncoder) {
+        d->streamEncoder->writeHead(d->scanProps);
+        d->streamEncoder->appendDef(def);
+        return;
+    }
+
     d->defQueue.push(def);
 }
 
+void JsonWriter::handleDef(Defect &&def)
+{
+    if (d->streamEncoder) {
+        d->streamEncoder->writeHead(d->scanProps);
+        d->streamEncoder->appendDef(def);
+        return;
+    }
+
+    // take over the defect instead of copying it
+    d->defQueue.push(std::move(def));
+}
+
 void JsonWriter::flush()
 {
+    if (d->streamEncoder) {
+        d->streamEncoder->writeTail(d->scanProps);
+        return;
+    }
+
     // transfer scan properties if available
     d->encoder->importScanProps(d->scanProps);
 
@@ -34,6 +34,7 @@ class JsonWriter: public AbstractWriter {
         void setScanProps(const TScanProps &) override;
 
         void handleDef(const Defect &def) override;
+        void handleDef(Defect &&def) override;
         void flush() override;
 
     private:
@@ -21,6 +21,7 @@
 
 #include "instream.hh"
 #include "regex.hh"
+#include "writer-binary.hh"
 #include "writer-cov.hh"
 #include "writer-html.hh"
 #include "writer-json.hh"
@@ -40,9 +41,19 @@ bool AbstractWriter::handleFile(Parser &parser)
         if (this->getScanProps().empty())
             this->setScanProps(parser.getScanProps());
 
-        Defect def;
-        while (parser.getNext(&def))
-            this->handleDef(def);
+        // read the defects in batches to save virtual calls per defect, the
+        // batch is kept small so that the defects stay in the CPU cache while
+        // they pass the chain of writers, and the parser overwrites them
+        // completely on each call
+        std::vector<Defect> batch(/* cnt */ 0x40);
+        size_t cnt;
+        while ((cnt = parser.getNextBatch(batch.data(), batch.size())))
+            this->handleDefs(batch.data(), cnt);
+
+        // streamed JSON input may carry scan properties after the defects
+        const TScanProps &trailingProps = parser.getScanProps();
+        if (this->getScanProps().empty() && !trailingProps.empty())
+            this->setScanProps(trailingProps);
 
         return ignoreParserWarnings_ || !parser.hasError();
 }
@@ -108,6 +119,10 @@ TWriterPtr createWriter(
         case FF_SARIF:
             writer.reset(new JsonWriter(strDst, FF_SARIF));
             break;
+
+        case FF_BINARY:
+            writer.reset(new BinaryWriter(strDst));
+            break;
     }
 
     if (!scanProps.empty())
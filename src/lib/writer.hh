@@ -29,6 +29,20 @@
 class AbstractWriter {
     public:
         virtual void handleDef(const Defect &def) = 0;
+
+        /// variant for defects the caller does not need any more, writers that
+        /// modify or store defects can override it to use def without a copy
+        virtual void handleDef(Defect &&def) {
+            this->handleDef(static_cast<const Defect &>(def));
+        }
+
+        /// handle cnt defects at once, the defects are owned by the caller but
+        /// the writer may modify them or take them over as in the variant above
+        virtual void handleDefs(Defect *defs, const size_t cnt) {
+            for (size_t i = 0U; i < cnt; ++i)
+                this->handleDef(std::move(defs[i]));
+        }
+
         virtual void notifyFile(const std::string &) { }
 
         AbstractWriter() = default;
@@ -0,0 +1,38 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2021 Red Hat, Inc.
+#
+# This file is part of csdiff.
+#
+# csdiff is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# any later version.
+#
+# csdiff is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with csdiff.  If not, see <http://www.gnu.org/licenses/>.
+
+# split the output of 'csdiff --added-and-fixed' into two JSON documents
+
+import json
+import sys
+
+if len(sys.argv) != 3:
+    sys.exit("usage: %s ADDED FIXED < INPUT" % sys.argv[0])
+
+doc = json.load(sys.stdin)
+keys = set(doc.keys())
+if keys != {"added", "fixed"} and keys != {"scan", "added", "fixed"}:
+    sys.exit("unexpected keys in the input document: %s" % sorted(keys))
+
+for key, fn in zip(["added", "fixed"], sys.argv[1:]):
+    out = {"defects": doc[key]}
+    if "scan" in doc:
+        out["scan"] = doc["scan"]
+    with open(fn, "w") as f:
+        json.dump(out, f, indent=4)
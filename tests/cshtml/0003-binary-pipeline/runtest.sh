@@ -0,0 +1,36 @@
+#!/bin/bash
+set -e
+set -x
+
+# reuse the data of the smoke test
+DATA_DIR="${TEST_SRC_DIR}/../0001-smoke"
+
+# pass the scans through csdiff and cssort in the binary format
+"${CSDIFF_BIN}" --binary-output                         \
+    "${DATA_DIR}/old/scan-results.json"                 \
+    "${DATA_DIR}/scan-results.json"                     \
+    | "${CSSORT_BIN}" --key=path --binary-output        \
+    | "${CSHTML_BIN}" --cwe-names "" -                  \
+    > added-binary.html
+
+# the same pipeline in the JSON format
+"${CSDIFF_BIN}" --json-output                           \
+    "${DATA_DIR}/old/scan-results.json"                 \
+    "${DATA_DIR}/scan-results.json"                     \
+    | "${CSSORT_BIN}" --key=path                        \
+    | "${CSHTML_BIN}" --cwe-names "" -                  \
+    > added-json.html
+
+diff -up added-json.html added-binary.html
+
+# binary output of csgrep read by cshtml, including --diff-base
+"${CSGREP_BIN}" --mode=binary "${DATA_DIR}/old/scan-results.json" > old.bin
+"${CSGREP_BIN}" --mode=binary "${DATA_DIR}/scan-results.json"     \
+    | "${CSHTML_BIN}"                                   \
+    --cwe-names ""                                      \
+    --diff-base old.bin                                 \
+    --diff-base-ignore-checkers "SHELLCHECK_WARNING"    \
+    --plain-text-url "scan-results.err"                 \
+    - > scan-results.html
+
+diff -up "${DATA_DIR}/scan-results.html" "${PWD}/scan-results.html"
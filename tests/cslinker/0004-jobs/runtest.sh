@@ -0,0 +1,24 @@
+#!/bin/bash
+set -e
+set -x
+
+# import ${JSFILTER_CMD}
+. ${TEST_SRC_DIR}/../../test-lib.sh
+
+# reuse the data of the smoke test
+DATA_DIR="${TEST_SRC_DIR}/../0001-smoke"
+
+# run cslinker with input files parsed in parallel
+"${CSLINKER_BIN}" \
+    --cwelist "${DATA_DIR}/cwe-map.csv"                 \
+    --implist "${DATA_DIR}/scan-results-imp.json"       \
+    --inifile "${DATA_DIR}/scan.ini"                    \
+    --reapply-parsing-rules                             \
+    --jobs 3                                            \
+    --quiet                                             \
+    "${DATA_DIR}/uni-results"/*                         \
+    | eval "${JSFILTER_CMD}"                            \
+    > scan-results.json
+
+# the output needs to be the same as if the files were parsed sequentially
+diff -up "${DATA_DIR}/scan-results.json" "${PWD}/scan-results.json"